@@ -27,20 +27,24 @@
 */
 #include "../src/Settings.h"
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 // Homing axis search distance multiplier. Computed by this value times the cycle travel.
 #ifndef HOMING_AXIS_SEARCH_SCALAR
-#    define HOMING_AXIS_SEARCH_SCALAR 1.1  // Must be > 1 to ensure limit switch will be engaged.
+#    define HOMING_AXIS_SEARCH_SCALAR 1.1f  // Must be > 1 to ensure limit switch will be engaged.
 #endif
 #ifndef HOMING_AXIS_LOCATE_SCALAR
-#    define HOMING_AXIS_LOCATE_SCALAR 2.0  // Must be > 1 to ensure limit switch is cleared.
+#    define HOMING_AXIS_LOCATE_SCALAR 2.0f  // Must be > 1 to ensure limit switch is cleared.
 #endif
 
 // The midTbot has a quirk where the x motor has to move twice as far as it would
 // on a normal T-Bot or CoreXY
 #ifndef MIDTBOT
-const float geometry_factor = 1.0;
+const float geometry_factor = 1.0f;
 #else
-const float geometry_factor = 2.0;
+const float geometry_factor = 2.0f;
 #endif
 
 static float last_motors[MAX_N_AXIS]    = { 0.0 };  // A place to save the previous motor angles for distance/feed rate calcs
@@ -122,12 +126,15 @@ bool user_defined_homing(uint8_t cycle_mask) {
                     // convert back to motor steps
                     inverse_kinematics(target);
 
-                    pl_data->feed_rate = homing_rate;   // feed or seek rates
-                    plan_buffer_line(target, pl_data);  // Bypass mc_line(). Directly plan homing motion.
-                    sys.step_control                  = {};
-                    sys.step_control.executeSysMotion = true;  // Set to execute homing motion and clear existing flags.
-                    st_prep_buffer();                          // Prep and fill segment buffer from newly planned block.
-                    st_wake_up();                              // Initiate motion
+                    pl_data->feed_rate = homing_rate;  // feed or seek rates
+                    {
+                        PlannerLock lock;
+                        plan_buffer_line(target, pl_data);  // Bypass mc_line(). Directly plan homing motion.
+                        sys.step_control                  = {};
+                        sys.step_control.executeSysMotion = true;  // Set to execute homing motion and clear existing flags.
+                        st_prep_buffer();                          // Prep and fill segment buffer from newly planned block.
+                    }
+                    st_wake_up();  // Initiate motion
 
                     do {
                         if (approach) {
@@ -171,7 +178,7 @@ bool user_defined_homing(uint8_t cycle_mask) {
 #ifdef USE_I2S_STEPS
                     if (current_stepper == ST_I2S_STREAM) {
                         if (!approach) {
-                            delay_ms(I2S_OUT_DELAY_MS);
+                            i2s_out_delay();  // Wait for the queued step pulses to be sent
                         }
                     }
 #endif
@@ -252,7 +259,7 @@ void inverse_kinematics(float* target, plan_line_data_t* pl_data, float* positio
     dx         = target[X_AXIS] - position[X_AXIS];
     dy         = target[Y_AXIS] - position[Y_AXIS];
     dz         = target[Z_AXIS] - position[Z_AXIS];
-    float dist = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    float dist = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
 
     motors[X_AXIS] = geometry_factor * target[X_AXIS] + target[Y_AXIS];
     motors[Y_AXIS] = geometry_factor * target[X_AXIS] - target[Y_AXIS];
@@ -274,8 +281,8 @@ void forward_kinematics(float* position) {
     float calc_fwd[MAX_N_AXIS];
 
     // https://corexy.com/theory.html
-    calc_fwd[X_AXIS] = 0.5 / geometry_factor * (position[X_AXIS] + position[Y_AXIS]);
-    calc_fwd[Y_AXIS] = 0.5 * (position[X_AXIS] - position[Y_AXIS]);
+    calc_fwd[X_AXIS] = 0.5f / geometry_factor * (position[X_AXIS] + position[Y_AXIS]);
+    calc_fwd[Y_AXIS] = 0.5f * (position[X_AXIS] - position[Y_AXIS]);
 
     position[X_AXIS] = calc_fwd[X_AXIS];
     position[Y_AXIS] = calc_fwd[Y_AXIS];
@@ -302,6 +309,6 @@ void user_m30() {}
 
 // Determine the unit distance between (2) 3D points
 float three_axis_dist(float* point1, float* point2) {
-    return sqrt(((point1[0] - point2[0]) * (point1[0] - point2[0])) + ((point1[1] - point2[1]) * (point1[1] - point2[1])) +
-                ((point1[2] - point2[2]) * (point1[2] - point2[2])));
+    return sqrtf(((point1[0] - point2[0]) * (point1[0] - point2[0])) + ((point1[1] - point2[1]) * (point1[1] - point2[1])) +
+                 ((point1[2] - point2[2]) * (point1[2] - point2[2])));
 }
@@ -129,6 +129,22 @@ void forward_kinematics(float* position) {
 void user_tool_change(uint8_t new_tool) {}
 #endif
 
+#ifdef USE_QUEUED_TOOL_CHANGE
+/*
+  user_tool_change_moves() is called when tool change gcode is received.
+  Instead of moving the machine, fill moves[] with the sequence, in
+  machine coordinates, and return the number of moves. moves[] has room
+  for capacity moves; if the sequence needs more, report it and return
+  0, so the change is not half done. A feed_rate of 0 is a rapid move.
+  After a move, outputs_on/outputs_off can switch the user digital
+  outputs, e.g. to release the tool, and dwell can wait for it. Both
+  wait for the machine to stop first.
+*/
+uint8_t user_tool_change_moves(uint8_t new_tool, tool_change_move_t* moves, uint8_t capacity) {
+    return 0;
+}
+#endif
+
 #if defined(MACRO_BUTTON_0_PIN) || defined(MACRO_BUTTON_1_PIN) || defined(MACRO_BUTTON_2_PIN)
 /*
   options.  user_defined_macro() is called with the button number to
@@ -56,6 +56,10 @@
 
 #include "../src/Settings.h"
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 enum class KinematicError : uint8_t {
     NONE               = 0,
     OUT_OF_RANGE       = 1,
@@ -71,13 +75,13 @@ FloatSetting* delta_crank_side_len;
 FloatSetting* delta_effector_side_len;
 
 // trigonometric constants to speed up calculations
-const float sqrt3  = 1.732050807;
-const float dtr    = M_PI / (float)180.0;  // degrees to radians
-const float sin120 = sqrt3 / 2.0;
-const float cos120 = -0.5;
+const float sqrt3  = 1.732050807f;
+const float dtr    = float(M_PI) / 180.0f;  // degrees to radians
+const float sin120 = sqrt3 / 2.0f;
+const float cos120 = -0.5f;
 const float tan60  = sqrt3;
-const float sin30  = 0.5;
-const float tan30  = 1.0 / sqrt3;
+const float sin30  = 0.5f;
+const float tan30  = 1.0f / sqrt3;
 
 // the geometry of the delta
 float rf;  // radius of the fixed side (length of motor cranks)
@@ -85,9 +89,9 @@ float re;  // radius of end effector side (length of linkages)
 float f;   // sized of fixed side triangel
 float e;   // size of end effector side triangle
 
-static float last_angle[3]          = { 0.0, 0.0, 0.0 };  // A place to save the previous motor angles for distance/feed rate calcs
+static float last_angle[3]          = { 0.0f, 0.0f, 0.0f };  // A place to save the previous motor angles for distance/feed rate calcs
 static float last_cartesian[N_AXIS] = {
-    0.0, 0.0, 0.0
+    0.0f, 0.0f, 0.0f
 };  // A place to save the previous motor angles for distance/feed rate calcs                             // Z offset of the effector from the arm centers
 
 // prototypes for helper functions
@@ -98,15 +102,15 @@ float          three_axis_dist(float* point1, float* point2);
 void           read_settings();
 
 void machine_init() {
-    float angles[N_AXIS]    = { 0.0, 0.0, 0.0 };
-    float cartesian[N_AXIS] = { 0.0, 0.0, 0.0 };
+    float angles[N_AXIS]    = { 0.0f, 0.0f, 0.0f };
+    float cartesian[N_AXIS] = { 0.0f, 0.0f, 0.0f };
 
     // Custom $ settings
-    kinematic_segment_len   = new FloatSetting(EXTENDED, WG, NULL, "Kinematics/SegmentLength", KINEMATIC_SEGMENT_LENGTH, 0.2, 1000.0);
-    delta_crank_len         = new FloatSetting(EXTENDED, WG, NULL, "Delta/CrankLength", RADIUS_FIXED, 50.0, 500.0);
-    delta_link_len          = new FloatSetting(EXTENDED, WG, NULL, "Delta/LinkLength", RADIUS_EFF, 50.0, 500.0);
-    delta_crank_side_len    = new FloatSetting(EXTENDED, WG, NULL, "Delta/CrankSideLength", LENGTH_FIXED_SIDE, 20.0, 500.0);
-    delta_effector_side_len = new FloatSetting(EXTENDED, WG, NULL, "Delta/EffectorSideLength", LENGTH_EFF_SIDE, 20.0, 500.0);
+    kinematic_segment_len   = new FloatSetting(EXTENDED, WG, NULL, "Kinematics/SegmentLength", KINEMATIC_SEGMENT_LENGTH, 0.2f, 1000.0f);
+    delta_crank_len         = new FloatSetting(EXTENDED, WG, NULL, "Delta/CrankLength", RADIUS_FIXED, 50.0f, 500.0f);
+    delta_link_len          = new FloatSetting(EXTENDED, WG, NULL, "Delta/LinkLength", RADIUS_EFF, 50.0f, 500.0f);
+    delta_crank_side_len    = new FloatSetting(EXTENDED, WG, NULL, "Delta/CrankSideLength", LENGTH_FIXED_SIDE, 20.0f, 500.0f);
+    delta_effector_side_len = new FloatSetting(EXTENDED, WG, NULL, "Delta/EffectorSideLength", LENGTH_EFF_SIDE, 20.0f, 500.0f);
 
     read_settings();
 
@@ -114,9 +118,10 @@ void machine_init() {
     // Z offset is the z distance from the motor axes to the end effector axes at zero angle
     calc_forward_kinematics(angles, cartesian);  // Sets the cartesian values
     // print a startup message to show the kinematics are enabled. Print the offset for reference
-    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Delta Kinematics Init: %s Z Offset:%4.3f", MACHINE_NAME, cartesian[Z_AXIS]);
+    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Delta Kinematics Init: %s Z Offset:%4.3f", MACHINE_NAME, double(cartesian[Z_AXIS]));
 
-    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Delta Angle Range %3.3f, %3.3f", MAX_NEGATIVE_ANGLE, MAX_POSITIVE_ANGLE);
+    grbl_msg_sendf(
+        CLIENT_SERIAL, MsgLevel::Info, "Delta Angle Range %3.3f, %3.3f", double(MAX_NEGATIVE_ANGLE), double(MAX_POSITIVE_ANGLE));
 
     //     grbl_msg_sendf(CLIENT_SERIAL,
     //                    MsgLevel::Info,
@@ -171,7 +176,12 @@ void inverse_kinematics(float* target, plan_line_data_t* pl_data, float* positio
     // Check the destination to see if it is in work area
     status = delta_calcInverse(target, motor_angles);
     if (status == KinematicError::OUT_OF_RANGE) {
-        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Target unreachable  error %3.3f %3.3f %3.3f", target[0], target[1], target[2]);
+        grbl_msg_sendf(CLIENT_SERIAL,
+                       MsgLevel::Info,
+                       "Target unreachable  error %3.3f %3.3f %3.3f",
+                       double(target[0]),
+                       double(target[1]),
+                       double(target[2]));
     }
 
     position[X_AXIS] += gc_state.coord_offset[X_AXIS];
@@ -182,10 +192,10 @@ void inverse_kinematics(float* target, plan_line_data_t* pl_data, float* positio
     dx         = target[X_AXIS] - position[X_AXIS];
     dy         = target[Y_AXIS] - position[Y_AXIS];
     dz         = target[Z_AXIS] - position[Z_AXIS];
-    float dist = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    float dist = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
 
     // determine the number of segments we need	... round up so there is at least 1 (except when dist is 0)
-    uint32_t segment_count = ceil(dist / kinematic_segment_len->get());
+    uint32_t segment_count = ceilf(dist / kinematic_segment_len->get());
 
     float segment_dist = dist / ((float)segment_count);  // distance of each segment...will be used for feedrate conversion
 
@@ -233,7 +243,8 @@ uint8_t kinematic_limits_check(float* target) {
 
     read_settings();
 
-    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Kin Soft Check %3.3f, %3.3f, %3.3f", target[0], target[1], target[2]);
+    grbl_msg_sendf(
+        CLIENT_SERIAL, MsgLevel::Info, "Kin Soft Check %3.3f, %3.3f, %3.3f", double(target[0]), double(target[1]), double(target[2]));
 
     KinematicError status = delta_calcInverse(target, motor_angles);
 
@@ -289,16 +300,16 @@ KinematicError delta_calcInverse(float* cartesian, float* angles) {
 int calc_forward_kinematics(float* angles, float* catesian) {
     float t = (f - e) * tan30 / 2;
 
-    float y1 = -(t + rf * cos(angles[0]));
-    float z1 = -rf * sin(angles[0]);
+    float y1 = -(t + rf * cosf(angles[0]));
+    float z1 = -rf * sinf(angles[0]);
 
-    float y2 = (t + rf * cos(angles[1])) * sin30;
+    float y2 = (t + rf * cosf(angles[1])) * sin30;
     float x2 = y2 * tan60;
-    float z2 = -rf * sin(angles[1]);
+    float z2 = -rf * sinf(angles[1]);
 
-    float y3 = (t + rf * cos(angles[2])) * sin30;
+    float y3 = (t + rf * cosf(angles[2])) * sin30;
     float x3 = -y3 * tan60;
-    float z3 = -rf * sin(angles[2]);
+    float z3 = -rf * sinf(angles[2]);
 
     float dnm = (y2 - y1) * x3 - (y3 - y1) * x2;
 
@@ -308,11 +319,11 @@ int calc_forward_kinematics(float* angles, float* catesian) {
 
     // x = (a1*z + b1)/dnm
     float a1 = (z2 - z1) * (y3 - y1) - (z3 - z1) * (y2 - y1);
-    float b1 = -((w2 - w1) * (y3 - y1) - (w3 - w1) * (y2 - y1)) / 2.0;
+    float b1 = -((w2 - w1) * (y3 - y1) - (w3 - w1) * (y2 - y1)) / 2.0f;
 
     // y = (a2*z + b2)/dnm;
     float a2 = -(z2 - z1) * x3 + (z3 - z1) * x2;
-    float b2 = ((w2 - w1) * x3 - (w3 - w1) * x2) / 2.0;
+    float b2 = ((w2 - w1) * x3 - (w3 - w1) * x2) / 2.0f;
 
     // a*z^2 + b*z + c = 0
     float a = a1 * a1 + a2 * a2 + dnm * dnm;
@@ -320,36 +331,36 @@ int calc_forward_kinematics(float* angles, float* catesian) {
     float c = (b2 - y1 * dnm) * (b2 - y1 * dnm) + b1 * b1 + dnm * dnm * (z1 * z1 - re * re);
 
     // discriminant
-    float d = b * b - (float)4.0 * a * c;
+    float d = b * b - 4.0f * a * c;
     if (d < 0)
         return -1;  // non-existing point
 
-    catesian[Z_AXIS] = -(float)0.5 * (b + sqrt(d)) / a;
+    catesian[Z_AXIS] = -0.5f * (b + sqrtf(d)) / a;
     catesian[X_AXIS] = (a1 * catesian[Z_AXIS] + b1) / dnm;
     catesian[Y_AXIS] = (a2 * catesian[Z_AXIS] + b2) / dnm;
     return 0;
 }
 // helper functions, calculates angle theta1 (for YZ-pane)
 KinematicError delta_calcAngleYZ(float x0, float y0, float z0, float& theta) {
-    float y1 = -0.5 * 0.57735 * f;  // f/2 * tg 30
-    y0 -= 0.5 * 0.57735 * e;        // shift center to edge
+    float y1 = -0.5f * 0.57735f * f;  // f/2 * tg 30
+    y0 -= 0.5f * 0.57735f * e;        // shift center to edge
     // z = a + b*y
     float a = (x0 * x0 + y0 * y0 + z0 * z0 + rf * rf - re * re - y1 * y1) / (2 * z0);
     float b = (y1 - y0) / z0;
     // discriminant
     float d = -(a + b * y1) * (a + b * y1) + rf * (b * b * rf + rf);
     if (d < 0)
-        return KinematicError::OUT_OF_RANGE;          // non-existing point
-    float yj = (y1 - a * b - sqrt(d)) / (b * b + 1);  // choosing outer point
+        return KinematicError::OUT_OF_RANGE;           // non-existing point
+    float yj = (y1 - a * b - sqrtf(d)) / (b * b + 1);  // choosing outer point
     float zj = a + b * yj;
     //theta    = 180.0 * atan(-zj / (y1 - yj)) / M_PI + ((yj > y1) ? 180.0 : 0.0);
-    theta = atan(-zj / (y1 - yj)) + ((yj > y1) ? M_PI : 0.0);
+    theta = atanf(-zj / (y1 - yj)) + ((yj > y1) ? float(M_PI) : 0.0f);
 
-    if (theta < MAX_NEGATIVE_ANGLE) {
+    if (theta < float(MAX_NEGATIVE_ANGLE)) {
         return KinematicError::ANGLE_TOO_NEGATIVE;
     }
 
-    if (theta > MAX_POSITIVE_ANGLE) {
+    if (theta > float(MAX_POSITIVE_ANGLE)) {
         return KinematicError::ANGLE_TOO_POSITIVE;
     }
 
@@ -358,8 +369,8 @@ KinematicError delta_calcAngleYZ(float x0, float y0, float z0, float& theta) {
 
 // Determine the unit distance between (2) 3D points
 float three_axis_dist(float* point1, float* point2) {
-    return sqrt(((point1[0] - point2[0]) * (point1[0] - point2[0])) + ((point1[1] - point2[1]) * (point1[1] - point2[1])) +
-                ((point1[2] - point2[2]) * (point1[2] - point2[2])));
+    return sqrtf(((point1[0] - point2[0]) * (point1[0] - point2[0])) + ((point1[1] - point2[1]) * (point1[1] - point2[1])) +
+                 ((point1[2] - point2[2]) * (point1[2] - point2[2])));
 }
 // called by reporting for WPos status
 void forward_kinematics(float* position) {
@@ -50,6 +50,10 @@
 
 */
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 // This file is enabled by defining CUSTOM_CODE_FILENAME "polar_coaster.cpp"
 // in Machines/polar_coaster.h, thus causing this file to be included
 // from ../custom_code.cpp
@@ -104,11 +108,11 @@ void inverse_kinematics(float* target, plan_line_data_t* pl_data, float* positio
     dz = target[Z_AXIS] - position[Z_AXIS];
     // calculate the total X,Y axis move distance
     // Z axis is the same in both coord systems, so it is ignored
-    dist = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    dist = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
     if (pl_data->motion.rapidMotion) {
         segment_count = 1;  // rapid G0 motion is not used to draw, so skip the segmentation
     } else {
-        segment_count = ceil(dist / SEGMENT_LENGTH);  // determine the number of segments we need	... round up so there is at least 1
+        segment_count = ceilf(dist / SEGMENT_LENGTH);  // determine the number of segments we need	... round up so there is at least 1
     }
     dist /= segment_count;  // segment distance
     for (uint32_t segment = 1; segment <= segment_count; segment++) {
@@ -122,17 +126,17 @@ void inverse_kinematics(float* target, plan_line_data_t* pl_data, float* positio
         p_dx                      = polar[RADIUS_AXIS] - last_radius;
         p_dy                      = polar[POLAR_AXIS] - last_angle;
         p_dz                      = dz;
-        polar_dist                = sqrt((p_dx * p_dx) + (p_dy * p_dy) + (p_dz * p_dz));  // calculate the total move distance
-        float polar_rate_multiply = 1.0;                                                  // fail safe rate
+        polar_dist                = sqrtf((p_dx * p_dx) + (p_dy * p_dy) + (p_dz * p_dz));  // calculate the total move distance
+        float polar_rate_multiply = 1.0f;                                                  // fail safe rate
         if (polar_dist == 0 || dist == 0) {
             // prevent 0 feed rate and division by 0
-            polar_rate_multiply = 1.0;  // default to same feed rate
+            polar_rate_multiply = 1.0f;  // default to same feed rate
         } else {
             // calc a feed rate multiplier
             polar_rate_multiply = polar_dist / dist;
-            if (polar_rate_multiply < 0.5) {
+            if (polar_rate_multiply < 0.5f) {
                 // prevent much slower speed
-                polar_rate_multiply = 0.5;
+                polar_rate_multiply = 0.5f;
             }
         }
         pl_data->feed_rate *= polar_rate_multiply;  // apply the distance ratio between coord systems
@@ -168,8 +172,8 @@ void forward_kinematics(float* position) {
     original_position[X_AXIS] = print_position[X_AXIS] - gc_state.coord_system[X_AXIS] + gc_state.coord_offset[X_AXIS];
     original_position[Y_AXIS] = print_position[Y_AXIS] - gc_state.coord_system[Y_AXIS] + gc_state.coord_offset[Y_AXIS];
     original_position[Z_AXIS] = print_position[Z_AXIS] - gc_state.coord_system[Z_AXIS] + gc_state.coord_offset[Z_AXIS];
-    position[X_AXIS]          = cos(radians(original_position[Y_AXIS])) * original_position[X_AXIS] * -1;
-    position[Y_AXIS]          = sin(radians(original_position[Y_AXIS])) * original_position[X_AXIS];
+    position[X_AXIS]          = cosf(original_position[Y_AXIS] * float(M_PI) / 180.0f) * original_position[X_AXIS] * -1;
+    position[Y_AXIS]          = sinf(original_position[Y_AXIS] * float(M_PI) / 180.0f) * original_position[X_AXIS];
     position[Z_AXIS]          = original_position[Z_AXIS];  // unchanged
 }
 
@@ -194,29 +198,29 @@ void calc_polar(float* target_xyz, float* polar, float last_angle) {
     if (polar[RADIUS_AXIS] == 0) {
         polar[POLAR_AXIS] = last_angle;  // don't care about angle at center
     } else {
-        polar[POLAR_AXIS] = atan2(target_xyz[Y_AXIS], target_xyz[X_AXIS]) * 180.0 / M_PI;
+        polar[POLAR_AXIS] = atan2f(target_xyz[Y_AXIS], target_xyz[X_AXIS]) * 180.0f / float(M_PI);
         // no negative angles...we want the absolute angle not -90, use 270
         polar[POLAR_AXIS] = abs_angle(polar[POLAR_AXIS]);
     }
     polar[Z_AXIS] = target_xyz[Z_AXIS];  // Z is unchanged
     delta_ang     = polar[POLAR_AXIS] - abs_angle(last_angle);
     // if the delta is above 180 degrees it means we are crossing the 0 degree line
-    if (fabs(delta_ang) <= 180.0)
+    if (fabsf(delta_ang) <= 180.0f)
         polar[POLAR_AXIS] = last_angle + delta_ang;
     else {
-        if (delta_ang > 0.0) {
+        if (delta_ang > 0.0f) {
             // crossing zero counter clockwise
-            polar[POLAR_AXIS] = last_angle - (360.0 - delta_ang);
+            polar[POLAR_AXIS] = last_angle - (360.0f - delta_ang);
         } else
-            polar[POLAR_AXIS] = last_angle + delta_ang + 360.0;
+            polar[POLAR_AXIS] = last_angle + delta_ang + 360.0f;
     }
 }
 
 // Return a 0-360 angle ... fix above 360 and below zero
 float abs_angle(float ang) {
-    ang = fmod(ang, 360.0);  // 0-360 or 0 to -360
-    if (ang < 0.0)
-        ang = 360.0 + ang;
+    ang = fmodf(ang, 360.0f);  // 0-360 or 0 to -360
+    if (ang < 0.0f)
+        ang = 360.0f + ang;
     return ang;
 }
 
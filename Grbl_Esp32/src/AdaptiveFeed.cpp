@@ -0,0 +1,60 @@
+/*
+  AdaptiveFeed.cpp - scales the feed rate to hold a target spindle load
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+static void adaptive_feed_set(Percent percent) {
+    if (percent == sys.f_adaptive) {
+        return;
+    }
+    sys.f_adaptive         = percent;
+    sys.report_ovr_counter = 0;  // Set to report change immediately
+    plan_update_velocity_profile_parameters();
+    plan_cycle_reinitialize();
+}
+
+void adaptive_feed_update() {
+    static int64_t next_update = 0;
+
+    float target = spindle_adaptive_load->get();
+    if (target <= 0.0 || sys.state == State::Idle) {
+        // Off, or between jobs: the next one starts at the programmed feed
+        adaptive_feed_set(FeedOverride::Default);
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now < next_update) {
+        return;
+    }
+    next_update = now + ADAPTIVE_FEED_PERIOD_MS * 1000;
+
+    // Hold the scaling while nothing is cut, e.g. during a feed hold
+    if (sys.state != State::Cycle || spindle->get_state() == SpindleState::Disable) {
+        return;
+    }
+    int32_t load = spindle->get_load();
+    if (load < 0) {
+        return;  // No (fresh) load reading
+    }
+
+    // Integrating control: each update moves the feed by a fraction of the relative load error.
+    float percent = sys.f_adaptive * (1.0 + spindle_adaptive_gain->get() * (target - load) / target);
+    percent       = constrain(percent, spindle_adaptive_min->get(), spindle_adaptive_max->get());
+    adaptive_feed_set(lroundf(percent));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/*
+  AdaptiveFeed.h - scales the feed rate to hold a target spindle load
+  Part of Grbl_ESP32
+
+  When $Spindle/Adaptive/Load is set, the feed of cutting moves is scaled
+  so that the spindle load, as reported by Spindle::get_load(), stays at
+  that percentage. The scaling is kept in sys.f_adaptive, separate from
+  the user feed override, and is limited to $Spindle/Adaptive/MinFeed
+  and $Spindle/Adaptive/MaxFeed. Rapids and system motions are not scaled.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+const int ADAPTIVE_FEED_PERIOD_MS = 200;  // The VFD is polled about as often
+
+// Called from the realtime loop. Updates sys.f_adaptive and replans if it changed.
+void adaptive_feed_update();
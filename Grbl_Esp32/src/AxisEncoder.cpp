@@ -0,0 +1,237 @@
+/*
+  AxisEncoder.cpp - closed loop position check of the stepper axes
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#include <driver/pcnt.h>
+
+// PCNT_UNIT_0 is the spindle encoder
+const int     AXIS_ENCODER_PCNT_UNIT0 = PCNT_UNIT_1;
+const int16_t AXIS_ENCODER_PCNT_LIM   = 30000;  // The counter is folded into encoder_base at these limits
+
+static const uint8_t encoder_a_pins[MAX_N_AXIS] = { X_ENCODER_A_PIN, Y_ENCODER_A_PIN, Z_ENCODER_A_PIN,
+                                                    A_ENCODER_A_PIN, B_ENCODER_A_PIN, C_ENCODER_A_PIN };
+static const uint8_t encoder_b_pins[MAX_N_AXIS] = { X_ENCODER_B_PIN, Y_ENCODER_B_PIN, Z_ENCODER_B_PIN,
+                                                    A_ENCODER_B_PIN, B_ENCODER_B_PIN, C_ENCODER_B_PIN };
+
+static uint8_t encoder_present = 0;  // Axes with an encoder input
+static uint8_t encoder_axes    = 0;  // Axes that are checked
+
+static volatile int32_t encoder_base[MAX_N_AXIS];  // Counts of the full counter cycles
+static int32_t          count_at_sync[MAX_N_AXIS];
+static int32_t          position_at_sync[MAX_N_AXIS];  // sys_position at the same time, in steps
+static int32_t          steps_per_count[MAX_N_AXIS];   // Q16
+static int32_t          max_error[MAX_N_AXIS];         // steps, 0 only reports
+
+// Errors in steps at the last segment boundaries, the newest at trace_head
+static int16_t trace[AXIS_ENCODER_TRACE][MAX_N_AXIS];
+static uint8_t trace_head  = 0;
+static uint8_t trace_count = 0;
+
+static volatile int8_t following_error_axis = -1;
+static xQueueHandle    following_error_queue;
+
+#ifdef AXIS_ENCODER_SIMULATED
+static volatile int32_t slip[MAX_N_AXIS];  // steps
+#else
+static void IRAM_ATTR axis_encoder_isr(void* arg) {
+    uint8_t  axis   = (uint32_t)arg;
+    uint32_t status = PCNT.status_unit[AXIS_ENCODER_PCNT_UNIT0 + axis].val;
+    if (status & PCNT_STATUS_H_LIM_M) {
+        encoder_base[axis] += AXIS_ENCODER_PCNT_LIM;
+    }
+    if (status & PCNT_STATUS_L_LIM_M) {
+        encoder_base[axis] -= AXIS_ENCODER_PCNT_LIM;
+    }
+}
+#endif
+
+// Counts of an axis. The simulated encoder counts steps.
+static int32_t IRAM_ATTR encoder_count(uint8_t axis) {
+#ifdef AXIS_ENCODER_SIMULATED
+    return sys_position[axis] + slip[axis];
+#else
+    int32_t base;
+    int16_t count;
+    do {  // The counter may fold into encoder_base in between
+        base  = encoder_base[axis];
+        count = PCNT.cnt_unit[AXIS_ENCODER_PCNT_UNIT0 + axis].cnt_val;
+    } while (base != encoder_base[axis]);
+    return base + count;
+#endif
+}
+
+// Difference between the motor and the encoder, in steps
+static int32_t IRAM_ATTR encoder_error(uint8_t axis) {
+    int64_t counts = encoder_count(axis) - count_at_sync[axis];
+    return (sys_position[axis] - position_at_sync[axis]) - (int32_t)((counts * steps_per_count[axis]) >> 16);
+}
+
+// Stops the machine outside of the stepper ISR, as mc_reset() also stops the spindle
+static void followingErrorTask(void* pvParameters) {
+    while (true) {
+        int axis;
+        xQueueReceive(following_error_queue, &axis, portMAX_DELAY);
+        mc_reset();
+        sys_rt_exec_alarm = ExecAlarm::FollowingError;
+        static UBaseType_t uxHighWaterMark = 0;
+        reportTaskStackSize(uxHighWaterMark);
+    }
+}
+
+void axis_encoder_init() {
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+#ifdef AXIS_ENCODER_SIMULATED
+        encoder_present |= bit(axis);
+#else
+        uint8_t pin_a = encoder_a_pins[axis];
+        uint8_t pin_b = encoder_b_pins[axis];
+        if (pin_a == UNDEFINED_PIN || pin_b == UNDEFINED_PIN) {
+            continue;
+        }
+        pcnt_unit_t   unit = pcnt_unit_t(AXIS_ENCODER_PCNT_UNIT0 + axis);
+        pcnt_config_t config;
+        config.pulse_gpio_num = pin_a;
+        config.ctrl_gpio_num  = pin_b;
+        config.channel        = PCNT_CHANNEL_0;
+        config.unit           = unit;
+        config.pos_mode       = PCNT_COUNT_INC;  // A rising
+        config.neg_mode       = PCNT_COUNT_DEC;  // A falling
+        config.lctrl_mode     = PCNT_MODE_KEEP;  // B low
+        config.hctrl_mode     = PCNT_MODE_REVERSE;
+        config.counter_h_lim  = AXIS_ENCODER_PCNT_LIM;
+        config.counter_l_lim  = -AXIS_ENCODER_PCNT_LIM;
+        pcnt_unit_config(&config);
+
+        pcnt_set_filter_value(unit, 100);  // 1.25 usec at 80MHz
+        pcnt_filter_enable(unit);
+        pcnt_event_enable(unit, PCNT_EVT_H_LIM);
+        pcnt_event_enable(unit, PCNT_EVT_L_LIM);
+        pcnt_counter_pause(unit);
+        pcnt_counter_clear(unit);
+        pcnt_isr_service_install(0);  // Shared with the spindle encoder, so it may be installed already
+        pcnt_isr_handler_add(unit, axis_encoder_isr, (void*)(uint32_t)axis);
+        pcnt_counter_resume(unit);
+
+        encoder_present |= bit(axis);
+        grbl_msg_sendf(CLIENT_SERIAL,
+                       MsgLevel::Info,
+                       "%s encoder A:%s B:%s",
+                       reportAxisNameMsg(axis),
+                       pinName(pin_a).c_str(),
+                       pinName(pin_b).c_str());
+#endif
+    }
+    if (encoder_present && following_error_queue == NULL) {
+        following_error_queue = xQueueCreate(1, sizeof(int));
+        xTaskCreate(followingErrorTask,
+                    "followingErrorTask",
+                    2048,
+                    NULL,
+                    5,  // priority
+                    NULL);
+    }
+#ifdef AXIS_ENCODER_SIMULATED
+    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Axis encoders simulated");
+#endif
+    axis_encoder_sync();
+}
+
+void axis_encoder_sync() {
+    uint8_t axes   = 0;
+    auto    n_axis = number_axis->get();
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        float resolution = axis_settings[axis]->encoder_resolution->get();
+        if (axis >= n_axis || !bitnum_istrue(encoder_present, axis) || resolution <= 0.0) {
+            continue;
+        }
+        float steps_per_mm = axis_settings[axis]->steps_per_mm->get();
+#ifdef AXIS_ENCODER_SIMULATED
+        resolution = steps_per_mm;  // The simulated encoder counts steps
+#endif
+        steps_per_count[axis] = lroundf(steps_per_mm / resolution * 65536.0);
+        max_error[axis]       = lroundf(axis_settings[axis]->encoder_max_error->get() * steps_per_mm);
+        axes |= bit(axis);
+    }
+    encoder_axes = 0;  // The stepper ISR must not compare while the reference changes
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        position_at_sync[axis] = sys_position[axis];
+        count_at_sync[axis]    = encoder_count(axis);
+    }
+    memset(trace, 0, sizeof(trace));
+    trace_count          = 0;
+    following_error_axis = -1;
+    encoder_axes         = axes;
+}
+
+uint8_t axis_encoder_axes() {
+    return encoder_axes;
+}
+
+void IRAM_ATTR axis_encoder_check() {
+    // sys_position jumps while homing. After an error, keep the trace until the reset.
+    if (!encoder_axes || sys.state == State::Homing || following_error_axis >= 0) {
+        return;
+    }
+    trace_head = (trace_head + 1) % AXIS_ENCODER_TRACE;
+    if (trace_count < AXIS_ENCODER_TRACE) {
+        trace_count++;
+    }
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        if (!bitnum_istrue(encoder_axes, axis)) {
+            continue;
+        }
+        int32_t error           = encoder_error(axis);
+        trace[trace_head][axis] = constrain(error, INT16_MIN, INT16_MAX);
+        if (max_error[axis] > 0 && abs(error) > max_error[axis] && following_error_axis < 0) {
+            following_error_axis = axis;
+            int evt              = axis;
+            xQueueSendFromISR(following_error_queue, &evt, NULL);
+        }
+    }
+}
+
+float axis_encoder_error(uint8_t axis) {
+    if (!bitnum_istrue(encoder_axes, axis)) {
+        return 0.0;
+    }
+    return encoder_error(axis) / axis_settings[axis]->steps_per_mm->get();
+}
+
+void axis_encoder_report_trace() {
+    int8_t axis = following_error_axis;
+    if (axis < 0) {
+        return;
+    }
+    // Oldest first, the last one is where the error was found
+    char  trace_rpt[AXIS_ENCODER_TRACE * 9 + 1] = "";
+    char  temp[12];
+    float mm_per_step = 1.0 / axis_settings[axis]->steps_per_mm->get();
+    for (uint8_t i = 0; i < trace_count; i++) {
+        uint8_t n = (trace_head + AXIS_ENCODER_TRACE - trace_count + 1 + i) % AXIS_ENCODER_TRACE;
+        sprintf(temp, " %.3f", trace[n][axis] * mm_per_step);
+        strcat(trace_rpt, temp);
+    }
+    grbl_msg_sendf(CLIENT_ALL, MsgLevel::Info, "%s following error trace:%s", reportAxisNameMsg(axis), trace_rpt);
+}
+
+#ifdef AXIS_ENCODER_SIMULATED
+void axis_encoder_slip(uint8_t axis, float mm) {
+    slip[axis] += lroundf(mm * axis_settings[axis]->steps_per_mm->get());
+}
+#endif
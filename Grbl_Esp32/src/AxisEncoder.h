@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+  AxisEncoder.h - closed loop position check of the stepper axes
+  Part of Grbl_ESP32
+
+  An axis with a quadrature encoder on X_ENCODER_A_PIN/X_ENCODER_B_PIN
+  (and so on for the other axes) is counted by a PCNT unit, like the
+  spindle encoder. The stepper ISR compares each encoder with
+  sys_position whenever it loads a segment. If the difference is more
+  than $X/Encoder/MaxError, the motors have lost steps: the machine is
+  stopped with a following error alarm and the recent errors of the
+  axis are reported.
+
+  $X/Encoder/Resolution is in counts per mm, and a count is one edge
+  of A, so it is twice the lines per mm of the encoder. 0 turns the
+  check of the axis off. The encoders are compared relative to the
+  position at the last reset or homing cycle, and the settings take
+  effect there too.
+
+  With AXIS_ENCODER_SIMULATED defined, every configured axis has an
+  encoder that follows its motor exactly, and $Encoder/Slip=X0.5
+  moves the simulated X encoder by 0.5mm, as if the motor had stalled.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+
+const int AXIS_ENCODER_TRACE = 16;  // Segment boundaries in the error trace
+
+// Set up the encoder inputs
+void axis_encoder_init();
+
+// Read the settings, and take the current encoder counts as sys_position
+void axis_encoder_sync();
+
+// Bit mask of the axes that are checked
+uint8_t axis_encoder_axes();
+
+// Compare the encoders with sys_position. Called by the stepper ISR.
+void axis_encoder_check();
+
+// Difference between the motor and the encoder of an axis, in mm
+float axis_encoder_error(uint8_t axis);
+
+// Report the error trace of the axis that raised the following error alarm
+void axis_encoder_report_trace();
+
+#ifdef AXIS_ENCODER_SIMULATED
+// Move the simulated encoder of an axis by mm
+void axis_encoder_slip(uint8_t axis, float mm);
+#endif
@@ -240,6 +240,11 @@ static const uint8_t NHomingLocateCycle = 1;  // Integer (1-128)
 // goes from 16 to 15 to make room for the additional line number data in the plan_block_t struct
 // #define USE_LINE_NUMBERS // Disabled by default. Uncomment to enable.
 
+// Times the motion of every g-code line in the stepper ISR, against the time it would take at its
+// programmed feed rate. $Trace/Lines reports the lines that fell short, see LineTiming.h. Needs
+// USE_LINE_NUMBERS.
+// #define LINE_TIMING // Disabled by default. Uncomment to enable.
+
 // Upon a successful probe cycle, this option provides immediately feedback of the probe coordinates
 // through an automatically generated message. If disabled, users can still access the last probe
 // coordinates through Grbl '$#' print parameters.
@@ -364,6 +369,13 @@ const int REPORT_WCO_REFRESH_IDLE_COUNT = 10;  // (2-255) Must be less than or e
 // certain the step segment buffer is increased/decreased to account for these changes.
 const int ACCELERATION_TICKS_PER_SECOND = 100;
 
+// A segment that only cruises at a constant speed may last up to this many acceleration ticks, as its
+// velocity is exact however long it is. This cuts the work of preparing segments on long moves. Behind
+// the running segment the buffer holds no more than SEGMENT_BUFFER_SIZE-2 ticks, so it has as long to
+// be refilled as with ordinary segments, but a feed hold or an override may start up to
+// CRUISE_SEGMENT_TICKS-1 ticks later. 1 makes every segment one acceleration tick long.
+const int CRUISE_SEGMENT_TICKS = 4;  // (1-255)
+
 // Sets the maximum step rate allowed to be written as a Grbl setting. This option enables an error
 // check in the settings module to prevent settings values that will exceed this limitation. The maximum
 // step rate is strictly limited by the CPU speed and will change if something other than an AVR running
@@ -414,13 +426,13 @@ const int TOOL_LENGTH_OFFSET_AXIS = Z_AXIS;  // Default z-axis. Valid values are
 // limits or angle between neighboring block line move directions. This is useful for machines that can't
 // tolerate the tool dwelling for a split second, i.e. 3d printers or laser cutters. If used, this value
 // should not be much greater than zero or to the minimum value necessary for the machine to work.
-const double MINIMUM_JUNCTION_SPEED = 0.0;  // (mm/min)
+const float MINIMUM_JUNCTION_SPEED = 0.0f;  // (mm/min)
 
 // Sets the minimum feed rate the planner will allow. Any value below it will be set to this minimum
 // value. This also ensures that a planned motion always completes and accounts for any floating-point
 // round-off errors. Although not recommended, a lower value than 1.0 mm/min will likely work in smaller
 // machines, perhaps to 0.1mm/min, but your success may vary based on multiple factors.
-const double MINIMUM_FEED_RATE = 1.0;  // (mm/min)
+const float MINIMUM_FEED_RATE = 1.0f;  // (mm/min)
 
 // Number of arc generation iterations by small angle approximation before exact arc trajectory
 // correction with expensive sin() and cos() calcualtions. This parameter maybe decreased if there
@@ -436,7 +448,18 @@ const int N_ARC_CORRECTION = 12;  // Integer (1-255)
 // This define value sets the machine epsilon cutoff to determine if the arc is a full-circle or not.
 // NOTE: Be very careful when adjusting this value. It should always be greater than 1.2e-7 but not too
 // much greater than this. The default setting should capture most, if not all, full arc error situations.
-const double ARC_ANGULAR_TRAVEL_EPSILON = 5E-7;  // Float (radians)
+const float ARC_ANGULAR_TRAVEL_EPSILON = 5E-7f;  // Float (radians)
+
+// Plans an arc as a single block instead of many short lines. The step segment generator traces
+// it along the true circle, so it runs at a constant feed rate with no junctions between chords,
+// and the planner buffer looks much further ahead along arcs. The feed rate around an arc is limited
+// to where the centripetal acceleration is within ARC_CENTRIPETAL_SHARE of the acceleration of its
+// plane axes, and the speed changes along it get what is left, so the two together stay within it.
+// Each step segment steps along up to ARC_SEGMENT_CHORDS chords of the arc. Arcs that also move axes
+// outside their plane and helix, and kinematic machines, still use line segments.
+// #define NATIVE_ARCS // Default disabled. Uncomment to enable.
+const float ARC_CENTRIPETAL_SHARE = 0.8f;  // Float (0-1)
+const int   ARC_SEGMENT_CHORDS    = 8;     // Integer (1-255)
 
 // Time delay increments performed during a dwell. The default value is set at 50ms, which provides
 // a maximum time delay of roughly 55 minutes, more than enough for most any application. Increasing
@@ -445,6 +468,20 @@ const double ARC_ANGULAR_TRAVEL_EPSILON = 5E-7;  // Float (radians)
 // time step. Also, keep in mind that the Arduino delay timer is not very accurate for long delays.
 const int DWELL_TIME_STEP = 50;  // Integer (1-255) (milliseconds)
 
+// Enables G33 spindle synchronized motion and G84 rigid tapping, with the spindle encoder described
+// in SpindleEncoder.h. Without it, the planner blocks do not carry a spindle position, and G33 and G84
+// are unsupported commands.
+// #define SPINDLE_SYNC // Default disabled. Uncomment to enable.
+
+// Enables G96 constant surface speed. Without it, the planner blocks do not carry the surface speed
+// and the X radius, and G96 is an unsupported command. The step segment generator sets the spindle
+// speed as the X radius changes. It sends a new speed only when it is more than CSS_RPM_HYSTERESIS
+// from the last one sent, and at most once every CSS_MIN_INTERVAL ms, so a VFD spindle on Modbus is
+// not flooded with commands.
+// #define CONSTANT_SURFACE_SPEED // Default disabled. Uncomment to enable.
+const float CSS_RPM_HYSTERESIS = 10.0f;  // Float (rpm)
+const int   CSS_MIN_INTERVAL   = 100;    // Integer (milliseconds)
+
 // For test use only. This uses the ESP32's RMT peripheral to generate step pulses
 // It allows the use of the STEP_PULSE_DELAY (see below) and it automatically ends the
 // pulse in one operation.
@@ -462,14 +499,15 @@ const int DWELL_TIME_STEP = 50;  // Integer (1-255) (milliseconds)
 // NOTE: Uncomment to enable. The recommended delay must be > 3us, and, when added with the
 // user-supplied step pulse time, the total time must not exceed 127us. Reported successful
 // values for certain setups have ranged from 5 to 20us.
-// must use #define USE_RMT_STEPS for this to work
+// must use #define USE_RMT_STEPS for this to work. The RMT peripheral times the delay, not the
+// output scheduler of the other stepping modes.
 //#define STEP_PULSE_DELAY 10 // Step pulse delay in microseconds. Default disabled.
 
 // The number of linear motions in the planner buffer to be planned at any give time. The vast
 // majority of RAM that Grbl uses is based on this buffer size. Only increase if there is extra
 // available RAM, like when re-compiling for a Mega2560. Or decrease if the Arduino begins to
 // crash due to the lack of available RAM or if the CPU is having trouble keeping up with planning
-// new incoming motions as they are executed.
+// new incoming motions as they are executed. $I reports the size of a block in this build.
 // #define BLOCK_BUFFER_SIZE 16 // Uncomment to override default in planner.h.
 
 // Governs the size of the intermediary step segment buffer between the step execution algorithm
@@ -480,6 +518,26 @@ const int DWELL_TIME_STEP = 50;  // Integer (1-255) (milliseconds)
 // before having to come back and refill this buffer, currently at ~50msec of step moves.
 // #define SEGMENT_BUFFER_SIZE 6 // Uncomment to override default in stepper.h.
 
+// Plans the parsed lines and fills the step segment buffer in a task on core 0, while the protocol
+// loop parses the next lines on core 1, so parsing and planning overlap on dense programs. mc_line()
+// queues its lines for the task, see PlannerTask.h.
+// #define PLANNER_TASK // Default disabled. Uncomment to enable.
+
+// Records the velocity profile of every planner block and the speed of every step segment, as
+// they are prepared for the stepper ISR. $Trace/Profile lists them, see ProfileTrace.h. Uses about
+// 17KB of RAM for the newest 128 blocks and 1024 segments.
+// #define PROFILE_TRACE // Default disabled. Uncomment to enable.
+// #define PROFILE_TRACE_BLOCKS 128 // Uncomment to override default in ProfileTrace.h.
+// #define PROFILE_TRACE_SEGMENTS 1024
+
+// The ESP32 FPU only handles float, and double math is done in software. With FLOAT_MATH_CHECK
+// defined, any promotion of float to double in the planner, the step segment generator, the arc
+// generator, the vector helpers they use, the input shaper and the CoreXY, parallel delta and
+// polar coaster kinematics is a compile error, and $Bench/Math reports the CPU cycles of their
+// float math against the double versions. The float_check environment in platformio.ini builds
+// with it.
+// #define FLOAT_MATH_CHECK // Default disabled. Uncomment to enable.
+
 // Line buffer size from the serial input stream to be executed. Also, governs the size of
 // each of the startup blocks, as they are each stored as a string of this size.
 // NOTE: 80 characters is not a problem except for extreme cases, but the line buffer size
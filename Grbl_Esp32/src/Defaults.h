@@ -42,6 +42,14 @@
 #    define DEFAULT_STEP_PULSE_MICROSECONDS 3  // $0
 #endif
 
+#ifndef DEFAULT_STEP_DIRECTION_DELAY
+#    define DEFAULT_STEP_DIRECTION_DELAY 0  // usec from a direction change to the step pulse
+#endif
+
+#ifndef DEFAULT_STEP_ENABLE_DELAY
+#    define DEFAULT_STEP_ENABLE_DELAY 0  // usec from enabling the drivers to the first step
+#endif
+
 #ifndef DEFAULT_STEPPER_IDLE_LOCK_TIME
 #    define DEFAULT_STEPPER_IDLE_LOCK_TIME 250  // $1 msec (0-254, 255 keeps steppers enabled)
 #endif
@@ -187,6 +195,38 @@
 #    define DEFAULT_SPINDLE_DELAY_SPINDOWN 0
 #endif
 
+#ifndef DEFAULT_SPINDLE_AT_SPEED_TOLERANCE
+#    define DEFAULT_SPINDLE_AT_SPEED_TOLERANCE 0.0  // percent of the target rpm. 0 = wait the fixed SpinUp delay
+#endif
+
+#ifndef DEFAULT_SPINDLE_AT_SPEED_TIMEOUT
+#    define DEFAULT_SPINDLE_AT_SPEED_TIMEOUT 10.0  // sec
+#endif
+
+#ifndef DEFAULT_SPINDLE_ENCODER_PPR
+#    define DEFAULT_SPINDLE_ENCODER_PPR 100  // lines per revolution
+#endif
+
+#ifndef DEFAULT_SPINDLE_RATED_CURRENT
+#    define DEFAULT_SPINDLE_RATED_CURRENT 0.0  // Amps, for the VFD load. 0 = unknown
+#endif
+
+#ifndef DEFAULT_SPINDLE_ADAPTIVE_LOAD
+#    define DEFAULT_SPINDLE_ADAPTIVE_LOAD 0.0  // percent spindle load to hold by scaling the feed. 0 = adaptive feed off
+#endif
+
+#ifndef DEFAULT_SPINDLE_ADAPTIVE_GAIN
+#    define DEFAULT_SPINDLE_ADAPTIVE_GAIN 0.2  // fraction of the relative load error corrected per update
+#endif
+
+#ifndef DEFAULT_SPINDLE_ADAPTIVE_MIN
+#    define DEFAULT_SPINDLE_ADAPTIVE_MIN 50  // percent of programmed feed
+#endif
+
+#ifndef DEFAULT_SPINDLE_ADAPTIVE_MAX
+#    define DEFAULT_SPINDLE_ADAPTIVE_MAX 150  // percent of programmed feed
+#endif
+
 #ifndef DEFAULT_INVERT_SPINDLE_OUTPUT_PIN
 #    define DEFAULT_INVERT_SPINDLE_OUTPUT_PIN 0
 #endif
@@ -283,7 +323,7 @@
 #endif
 
 // ============== Axis Acceleration =========
-#define SEC_PER_MIN_SQ (60.0 * 60.0)  // Seconds Per Minute Squared, for acceleration conversion
+#define SEC_PER_MIN_SQ (60.0f * 60.0f)  // Seconds Per Minute Squared, for acceleration conversion
 // Default accelerations are expressed in mm/sec^2
 #ifndef DEFAULT_X_ACCELERATION
 #    define DEFAULT_X_ACCELERATION 200.0
@@ -451,6 +491,99 @@
 #    define DEFAULT_C_STALLGUARD 16  // $175 stallguard (extended set)
 #endif
 
+// ========== Input shaping ================
+
+#ifndef DEFAULT_X_SHAPER_TYPE
+#    define DEFAULT_X_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_Y_SHAPER_TYPE
+#    define DEFAULT_Y_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_Z_SHAPER_TYPE
+#    define DEFAULT_Z_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_A_SHAPER_TYPE
+#    define DEFAULT_A_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_B_SHAPER_TYPE
+#    define DEFAULT_B_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_C_SHAPER_TYPE
+#    define DEFAULT_C_SHAPER_TYPE 0  // 0 NONE, 1 ZV, 2 ZVD, 3 EI (extended set)
+#endif
+#ifndef DEFAULT_X_SHAPER_FREQUENCY
+#    define DEFAULT_X_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_Y_SHAPER_FREQUENCY
+#    define DEFAULT_Y_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_Z_SHAPER_FREQUENCY
+#    define DEFAULT_Z_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_A_SHAPER_FREQUENCY
+#    define DEFAULT_A_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_B_SHAPER_FREQUENCY
+#    define DEFAULT_B_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_C_SHAPER_FREQUENCY
+#    define DEFAULT_C_SHAPER_FREQUENCY 40.0  // Hz, resonance of the axis (extended set)
+#endif
+#ifndef DEFAULT_X_SHAPER_DAMPING
+#    define DEFAULT_X_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_Y_SHAPER_DAMPING
+#    define DEFAULT_Y_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_Z_SHAPER_DAMPING
+#    define DEFAULT_Z_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_A_SHAPER_DAMPING
+#    define DEFAULT_A_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_B_SHAPER_DAMPING
+#    define DEFAULT_B_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_C_SHAPER_DAMPING
+#    define DEFAULT_C_SHAPER_DAMPING 0.1  // damping ratio of the resonance (extended set)
+#endif
+#ifndef DEFAULT_X_ENCODER_RESOLUTION
+#    define DEFAULT_X_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_Y_ENCODER_RESOLUTION
+#    define DEFAULT_Y_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_Z_ENCODER_RESOLUTION
+#    define DEFAULT_Z_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_A_ENCODER_RESOLUTION
+#    define DEFAULT_A_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_B_ENCODER_RESOLUTION
+#    define DEFAULT_B_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_C_ENCODER_RESOLUTION
+#    define DEFAULT_C_ENCODER_RESOLUTION 0.0  // counts/mm, 0 turns the check off (extended set)
+#endif
+#ifndef DEFAULT_X_ENCODER_MAX_ERROR
+#    define DEFAULT_X_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+#ifndef DEFAULT_Y_ENCODER_MAX_ERROR
+#    define DEFAULT_Y_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+#ifndef DEFAULT_Z_ENCODER_MAX_ERROR
+#    define DEFAULT_Z_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+#ifndef DEFAULT_A_ENCODER_MAX_ERROR
+#    define DEFAULT_A_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+#ifndef DEFAULT_B_ENCODER_MAX_ERROR
+#    define DEFAULT_B_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+#ifndef DEFAULT_C_ENCODER_MAX_ERROR
+#    define DEFAULT_C_ENCODER_MAX_ERROR 0.5  // mm, 0 only reports the error (extended set)
+#endif
+
 // ==================  pin defaults ========================
 
 // Here is a place to default pins to UNDEFINED_PIN.
@@ -631,6 +764,62 @@
 #    define PROBE_PIN UNDEFINED_PIN
 #endif
 
+#ifndef SPINDLE_ENCODER_A_PIN
+#    define SPINDLE_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef SPINDLE_ENCODER_B_PIN
+#    define SPINDLE_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef X_ENCODER_A_PIN
+#    define X_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef X_ENCODER_B_PIN
+#    define X_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef Y_ENCODER_A_PIN
+#    define Y_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef Y_ENCODER_B_PIN
+#    define Y_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef Z_ENCODER_A_PIN
+#    define Z_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef Z_ENCODER_B_PIN
+#    define Z_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef A_ENCODER_A_PIN
+#    define A_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef A_ENCODER_B_PIN
+#    define A_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef B_ENCODER_A_PIN
+#    define B_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef B_ENCODER_B_PIN
+#    define B_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
+#ifndef C_ENCODER_A_PIN
+#    define C_ENCODER_A_PIN UNDEFINED_PIN
+#endif
+
+#ifndef C_ENCODER_B_PIN
+#    define C_ENCODER_B_PIN UNDEFINED_PIN
+#endif
+
 #ifndef USER_ANALOG_PIN_0_FREQ
 #    define USER_ANALOG_PIN_0_FREQ 5000
 #endif
@@ -12,4 +12,5 @@ std::map<ExecAlarm, const char*> AlarmNames = {
     { ExecAlarm::HomingFailPulloff, "Homing Fail Pulloff"},
     { ExecAlarm::HomingFailApproach, "Homing Fail Approach"},
     { ExecAlarm::SpindleControl, "Spindle Control"},
+    { ExecAlarm::FollowingError, "Following Error"},
 };
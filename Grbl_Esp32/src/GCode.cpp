@@ -36,12 +36,81 @@ parser_block_t gc_block;
 
 #define FAIL(status) return (status);
 
+// The drilling and tapping cycles share the retained words and the G98/G99 return levels
+static bool is_canned_cycle(Motion motion) {
+    switch (motion) {
+        case Motion::ChipBreakDrill:
+        case Motion::Drill:
+        case Motion::DrillDwell:
+        case Motion::PeckDrill:
+        case Motion::RigidTap:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Offsets of a work coordinate system: one of G54-G59, or a fixture of G54.1
+static void gc_get_coord_system(CoordIndex coord_select, uint8_t fixture, float* coord_data) {
+    if (fixture) {
+        offset_table->getFixture(fixture, coord_data);
+    } else {
+        coords[coord_select]->get(coord_data);
+    }
+}
+
 void gc_init() {
     // Reset parser state:
     memset(&gc_state, 0, sizeof(parser_state_t));
     // Load default G54 coordinate system.
     gc_state.modal.coord_select = CoordIndex::G54;
     coords[gc_state.modal.coord_select]->get(gc_state.coord_system);
+    gc_update_work_offset();
+}
+
+void gc_update_work_offset() {
+    for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+        gc_state.work_offset[idx] = gc_state.coord_system[idx] + gc_state.coord_offset[idx];
+    }
+    gc_state.work_offset[TOOL_LENGTH_OFFSET_AXIS] += gc_state.tool_length_offset;
+
+    // machine = R * S * (work - scale_center) + R * (scale_center - rotation_center) + rotation_center + work_offset
+    float angle       = gc_state.rotated ? gc_state.rotation * float(M_PI) / 180.0f : 0.0f;
+    gc_state.work_sin = sinf(angle);
+    gc_state.work_cos = cosf(angle);
+    for (uint8_t idx = X_AXIS; idx <= Z_AXIS; idx++) {
+        gc_state.work_scale[idx] = gc_state.scaled ? gc_state.scale[idx] : 1.0f;
+    }
+    float x                     = (1.0f - gc_state.work_scale[X_AXIS]) * gc_state.scale_center[X_AXIS] - gc_state.rotation_center[X_AXIS];
+    float y                     = (1.0f - gc_state.work_scale[Y_AXIS]) * gc_state.scale_center[Y_AXIS] - gc_state.rotation_center[Y_AXIS];
+    gc_state.work_shift[X_AXIS] = x * gc_state.work_cos - y * gc_state.work_sin + gc_state.rotation_center[X_AXIS];
+    gc_state.work_shift[Y_AXIS] = x * gc_state.work_sin + y * gc_state.work_cos + gc_state.rotation_center[Y_AXIS];
+    gc_state.work_shift[Z_AXIS] = (1.0f - gc_state.work_scale[Z_AXIS]) * gc_state.scale_center[Z_AXIS];
+    gc_state.work_transformed   = gc_state.rotated || gc_state.scaled;
+}
+
+void gc_work_to_machine(const float* work, const float* offset, float* machine) {
+    float x = work[X_AXIS] * gc_state.work_scale[X_AXIS];
+    float y = work[Y_AXIS] * gc_state.work_scale[Y_AXIS];
+    float z = work[Z_AXIS] * gc_state.work_scale[Z_AXIS];
+    for (uint8_t idx = Z_AXIS + 1; idx < MAX_N_AXIS; idx++) {
+        machine[idx] = work[idx] + offset[idx];
+    }
+    machine[X_AXIS] = x * gc_state.work_cos - y * gc_state.work_sin + gc_state.work_shift[X_AXIS] + offset[X_AXIS];
+    machine[Y_AXIS] = x * gc_state.work_sin + y * gc_state.work_cos + gc_state.work_shift[Y_AXIS] + offset[Y_AXIS];
+    machine[Z_AXIS] = z + gc_state.work_shift[Z_AXIS] + offset[Z_AXIS];
+}
+
+void gc_machine_to_work(const float* machine, const float* offset, float* work) {
+    float x = machine[X_AXIS] - gc_state.work_shift[X_AXIS] - offset[X_AXIS];
+    float y = machine[Y_AXIS] - gc_state.work_shift[Y_AXIS] - offset[Y_AXIS];
+    float z = machine[Z_AXIS] - gc_state.work_shift[Z_AXIS] - offset[Z_AXIS];
+    for (uint8_t idx = Z_AXIS + 1; idx < MAX_N_AXIS; idx++) {
+        work[idx] = machine[idx] - offset[idx];
+    }
+    work[X_AXIS] = (x * gc_state.work_cos + y * gc_state.work_sin) / gc_state.work_scale[X_AXIS];
+    work[Y_AXIS] = (y * gc_state.work_cos - x * gc_state.work_sin) / gc_state.work_scale[Y_AXIS];
+    work[Z_AXIS] = z / gc_state.work_scale[Z_AXIS];
 }
 
 // Sets g-code parser position in mm. Input in steps. Called by the system abort and hard
@@ -132,7 +201,9 @@ Error gc_execute_line(char* line, uint8_t client) {
     memcpy(&gc_block.modal, &gc_state.modal, sizeof(gc_modal_t));  // Copy current modes
     AxisCommand axis_command = AxisCommand::None;
     uint8_t     axis_0, axis_1, axis_linear;
-    CoordIndex  coord_select = CoordIndex::G54;  // Tracks G10 P coordinate selection for execution
+    CoordIndex  coord_select   = CoordIndex::G54;  // Tracks G10 P coordinate selection for execution
+    uint8_t     fixture        = 0;                // Tracks G10 P fixture selection for execution
+    bool        fixture_select = false;            // G54.1 is in the block
     // Initialize bitflag tracking variables for axis indices compatible operations.
     uint8_t axis_words = 0;  // XYZ tracking
     uint8_t ijk_words  = 0;  // IJK tracking
@@ -143,6 +214,7 @@ Error gc_execute_line(char* line, uint8_t client) {
     auto     n_axis          = number_axis->get();
     float    coord_data[MAX_N_AXIS];  // Used by WCO-related commands
     uint8_t  pValue;                  // Integer value of P word
+    uint32_t canned_words = 0;        // Canned cycle words given in this block or retained
 
     // Determine if the line is a jogging motion or a normal g-code block.
     if (line[0] == '$') {  // NOTE: `$J=` already parsed when passed to this function.
@@ -244,6 +316,24 @@ Error gc_execute_line(char* line, uint8_t client) {
                         gc_block.non_modal_command = NonModal::Dwell;
                         mg_word_bit                = ModalGroup::MG0;
                         break;
+                    case 51:  // G51 - scaling
+                    case 68:  // G68 - coordinate system rotation
+                        // The axis words are the center
+                        gc_block.non_modal_command = int_value == 51 ? NonModal::SetScaling : NonModal::SetRotation;
+                        if (axis_command != AxisCommand::None) {
+                            FAIL(Error::GcodeAxisCommandConflict);  // [Axis word/command conflict]
+                        }
+                        axis_command = AxisCommand::NonModal;
+                        mg_word_bit  = ModalGroup::MG0;
+                        break;
+                    case 50:  // G50 - cancel scaling
+                        gc_block.non_modal_command = NonModal::CancelScaling;
+                        mg_word_bit                = ModalGroup::MG0;
+                        break;
+                    case 69:  // G69 - cancel rotation
+                        gc_block.non_modal_command = NonModal::CancelRotation;
+                        mg_word_bit                = ModalGroup::MG0;
+                        break;
                     case 53:
                         gc_block.non_modal_command = NonModal::AbsoluteOverride;
                         mg_word_bit                = ModalGroup::MG0;
@@ -270,6 +360,61 @@ Error gc_execute_line(char* line, uint8_t client) {
                         gc_block.modal.motion = Motion::CcwArc;
                         mg_word_bit           = ModalGroup::MG1;
                         break;
+                    case 33:  // G33 - spindle synchronized motion
+#ifndef SPINDLE_SYNC
+                        FAIL(Error::GcodeUnsupportedCommand);  // [Built without SPINDLE_SYNC]
+#endif
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::SpindleSync;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 73:  // G73 - chip breaking drilling cycle
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::ChipBreakDrill;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 81:  // G81 - drilling cycle
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::Drill;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 82:  // G82 - drilling cycle with dwell
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::DrillDwell;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 83:  // G83 - peck drilling cycle
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::PeckDrill;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 84:  // G84 - rigid tapping cycle
+#ifndef SPINDLE_SYNC
+                        FAIL(Error::GcodeUnsupportedCommand);  // [Built without SPINDLE_SYNC]
+#endif
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::RigidTap;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 98:  // G98 - canned cycles return to the initial level
+                        gc_block.modal.retract = RetractMode::InitialLevel;
+                        mg_word_bit            = ModalGroup::MG10;
+                        break;
+                    case 99:  // G99 - canned cycles return to the R level
+                        gc_block.modal.retract = RetractMode::RLevel;
+                        mg_word_bit            = ModalGroup::MG10;
+                        break;
+                    case 96:  // G96 - constant surface speed
+#ifndef CONSTANT_SURFACE_SPEED
+                        FAIL(Error::GcodeUnsupportedCommand);  // [Built without CONSTANT_SURFACE_SPEED]
+#endif
+                        gc_block.modal.spindle_speed_mode = SpindleSpeedMode::SurfaceSpeed;
+                        mg_word_bit                       = ModalGroup::MG14;
+                        break;
+                    case 97:  // G97 - spindle speed in RPM
+                        gc_block.modal.spindle_speed_mode = SpindleSpeedMode::Rpm;
+                        mg_word_bit                       = ModalGroup::MG14;
+                        break;
                     case 38:  // G38 - probe
                         //only allow G38 "Probe" commands if a probe pin is defined.
                         if (PROBE_PIN == UNDEFINED_PIN) {
@@ -388,6 +533,8 @@ Error gc_execute_line(char* line, uint8_t client) {
                             gc_block.modal.tool_length = ToolLengthOffset::Cancel;
                         } else if (mantissa == 10) {  // G43.1
                             gc_block.modal.tool_length = ToolLengthOffset::EnableDynamic;
+                        } else if (mantissa == 0) {  // G43
+                            gc_block.modal.tool_length = ToolLengthOffset::EnableTable;
                         } else {
                             FAIL(Error::GcodeUnsupportedCommand);  // [Unsupported G43.x command]
                         }
@@ -395,6 +542,10 @@ Error gc_execute_line(char* line, uint8_t client) {
                         mg_word_bit = ModalGroup::MG8;
                         break;
                     case 54:
+                        if (mantissa == 10) {  // G54.1 - the fixture is the P word
+                            fixture_select = true;
+                            mantissa       = 0;  // Set to zero to indicate valid non-integer G command.
+                        }
                         gc_block.modal.coord_select = CoordIndex::G54;
                         mg_word_bit                 = ModalGroup::MG12;
                         break;
@@ -587,7 +738,10 @@ Error gc_execute_line(char* line, uint8_t client) {
                             FAIL(Error::GcodeUnsupportedCommand);
                         }
                         break;
-                    // case 'D': // Not supported
+                    case 'D':
+                        axis_word_bit     = GCodeWord::D;
+                        gc_block.values.d = value;
+                        break;
                     case 'E':
                         axis_word_bit     = GCodeWord::E;
                         gc_block.values.e = int_value;
@@ -597,7 +751,16 @@ Error gc_execute_line(char* line, uint8_t client) {
                         axis_word_bit     = GCodeWord::F;
                         gc_block.values.f = value;
                         break;
-                    // case 'H': // Not supported
+                    case 'H':
+                        axis_word_bit     = GCodeWord::H;
+                        gc_block.values.h = int_value;
+                        if (value < 0.0) {
+                            FAIL(Error::NegativeValue);
+                        }
+                        if (value > N_TOOL_TABLE) {
+                            FAIL(Error::GcodeMaxValueExceeded);
+                        }
+                        break;
                     case 'I':
                         axis_word_bit               = GCodeWord::I;
                         gc_block.values.ijk[X_AXIS] = value;
@@ -682,9 +845,10 @@ Error gc_execute_line(char* line, uint8_t client) {
                 if (bit_istrue(value_words, bitmask)) {
                     FAIL(Error::GcodeWordRepeated);  // [Word repeated]
                 }
-                // Check for invalid negative values for words F, N, P, T, and S.
+                // Check for invalid negative values for words F, N, P, T, S and D.
                 // NOTE: Negative value check is done here simply for code-efficiency.
-                if (bitmask & (bit(GCodeWord::F) | bit(GCodeWord::N) | bit(GCodeWord::P) | bit(GCodeWord::T) | bit(GCodeWord::S))) {
+                if (bitmask & (bit(GCodeWord::F) | bit(GCodeWord::N) | bit(GCodeWord::P) | bit(GCodeWord::T) | bit(GCodeWord::S) |
+                               bit(GCodeWord::D))) {
                     if (value < 0.0) {
                         FAIL(Error::NegativeValue);  // [Word value cannot be negative]
                     }
@@ -786,7 +950,36 @@ Error gc_execute_line(char* line, uint8_t client) {
     }
     // bit_false(value_words,bit(GCodeWord::F)); // NOTE: Single-meaning value word. Set at end of error-checking.
     // [4. Set spindle speed ]: S is negative (done.)
-    if (bit_isfalse(value_words, bit(GCodeWord::S))) {
+    // - With G96, S is the surface speed in m/min, or ft/min in inches mode, and D limits the spindle
+    //   speed. S is required to enter G96. The spindle speed is the one at the current X radius, and
+    //   the step segment generator changes it with the radius as the tool moves.
+    // - The radius is taken in X, so G96 cannot be used with G68 rotation or G51 scaling.
+    float surface_speed = 0.0f;
+    if (gc_block.modal.spindle_speed_mode == SpindleSpeedMode::SurfaceSpeed) {
+        bool rotated = gc_state.rotated && gc_block.non_modal_command != NonModal::CancelRotation;
+        bool scaled  = gc_state.scaled && gc_block.non_modal_command != NonModal::CancelScaling;
+        if (rotated || scaled || gc_block.non_modal_command == NonModal::SetRotation ||
+            gc_block.non_modal_command == NonModal::SetScaling) {
+            FAIL(Error::GcodeUnsupportedCommand);  // [G96 with G68 or G51]
+        }
+        if (bit_istrue(value_words, bit(GCodeWord::S))) {
+            surface_speed = gc_block.values.s * (gc_block.modal.units == Units::Inches ? MM_PER_INCH * 12 : 1000);
+        } else if (gc_state.modal.spindle_speed_mode == SpindleSpeedMode::SurfaceSpeed) {
+            surface_speed = gc_state.surface_speed;
+        } else {
+            FAIL(Error::GcodeValueWordMissing);  // [G96 without S]
+        }
+        if (bit_isfalse(value_words, bit(GCodeWord::D))) {
+            if (gc_state.modal.spindle_speed_mode == SpindleSpeedMode::SurfaceSpeed) {
+                gc_block.values.d = gc_state.max_spindle_speed;
+            } else {
+                gc_block.values.d = rpm_max->get();
+            }
+        }
+        bit_false(value_words, bit(GCodeWord::D));
+        float radius      = fabsf(gc_state.position[X_AXIS] - gc_state.work_offset[X_AXIS]);
+        gc_block.values.s = MIN(surface_speed / (2 * float(M_PI) * radius), gc_block.values.d);
+    } else if (bit_isfalse(value_words, bit(GCodeWord::S))) {
         gc_block.values.s = gc_state.spindle_speed;
         // bit_false(value_words,bit(GCodeWord::S)); // NOTE: Single-meaning value word. Set at end of error-checking.
         // [5. Select tool ]: NOT SUPPORTED. Only tracks value. T is negative (done.) Not an integer. Greater than max tool value.
@@ -860,16 +1053,30 @@ Error gc_execute_line(char* line, uint8_t client) {
     // [G40 Errors]: G2/3 arc is programmed after a G40. The linear move after disabling is less than tool diameter.
     //   NOTE: Since cutter radius compensation is never enabled, these G40 errors don't apply. Grbl supports G40
     //   only for the purpose to not error when G40 is sent with a g-code program header to setup the default modes.
-    // [14. Cutter length compensation ]: G43 NOT SUPPORTED, but G43.1 and G49 are.
+    // [14. Cutter length compensation ]: G43, G43.1 and G49 are supported.
     // [G43.1 Errors]: Motion command in same line.
     //   NOTE: Although not explicitly stated so, G43.1 should be applied to only one valid
     //   axis that is configured (in config.h). There should be an error if the configured axis
     //   is absent or if any of the other axis words are present.
+    // [G43 Errors]: Axis words present. No H word and the selected tool is not in the tool table.
+    //   NOTE: Without H, the length of the last T word tool is used. H0 is no offset.
     if (axis_command == AxisCommand::ToolLengthOffset) {  // Indicates called in block.
         if (gc_block.modal.tool_length == ToolLengthOffset::EnableDynamic) {
             if (axis_words ^ bit(TOOL_LENGTH_OFFSET_AXIS)) {
                 FAIL(Error::GcodeG43DynamicAxisError);
             }
+        } else if (gc_block.modal.tool_length == ToolLengthOffset::EnableTable) {
+            if (axis_words) {
+                FAIL(Error::GcodeAxisWordsExist);
+            }
+            if (bit_isfalse(value_words, bit(GCodeWord::H))) {
+                if (gc_state.tool > N_TOOL_TABLE) {
+                    FAIL(Error::GcodeMaxValueExceeded);  // [Tool not in the table]
+                }
+                gc_block.values.h = gc_state.tool;
+            }
+            bit_false(value_words, bit(GCodeWord::H));
+            gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS] = offset_table->toolLength(gc_block.values.h);
         }
     }
     // [15. Coordinate system selection ]: *N/A. Error, if cutter radius comp is active.
@@ -877,16 +1084,36 @@ Error gc_execute_line(char* line, uint8_t client) {
     // is active. The read pauses the processor temporarily and may cause a rare crash. For
     // future versions on processors with enough memory, all coordinate data should be stored
     // in memory and written to non-volatile storage only when there is not a cycle active.
-    float block_coord_system[MAX_N_AXIS];
-    memcpy(block_coord_system, gc_state.coord_system, sizeof(gc_state.coord_system));
+    // NOTE: The block uses the offsets of gc_state, unless it selects another coordinate system.
+    float* block_coord_system = gc_state.coord_system;
+    float* block_work_offset  = gc_state.work_offset;
+    float  new_coord_system[MAX_N_AXIS];
+    float  new_work_offset[MAX_N_AXIS];
     if (bit_istrue(command_words, bit(ModalGroup::MG12))) {  // Check if called in block
         // This error probably cannot happen because preceding code sets
         // gc_block.modal.coord_select only to specific supported values
         if (gc_block.modal.coord_select >= CoordIndex::NWCSystems) {
             FAIL(Error::GcodeUnsupportedCoordSys);  // [Greater than N sys]
         }
-        if (gc_state.modal.coord_select != gc_block.modal.coord_select) {
-            coords[gc_block.modal.coord_select]->get(block_coord_system);
+        // [G54.1 Errors]: P word missing. P is not a fixture of the table.
+        gc_block.modal.fixture = 0;
+        if (fixture_select) {
+            if (bit_isfalse(value_words, bit(GCodeWord::P))) {
+                FAIL(Error::GcodeValueWordMissing);  // [P word missing]
+            }
+            if (gc_block.values.p < 1.0 || gc_block.values.p >= N_FIXTURE_TABLE + 1) {
+                FAIL(Error::GcodeUnsupportedCoordSys);  // [No such fixture]
+            }
+            gc_block.modal.fixture = trunc(gc_block.values.p);
+            bit_false(value_words, bit(GCodeWord::P));
+        }
+        if (gc_state.modal.coord_select != gc_block.modal.coord_select || gc_state.modal.fixture != gc_block.modal.fixture) {
+            gc_get_coord_system(gc_block.modal.coord_select, gc_block.modal.fixture, new_coord_system);
+            for (idx = 0; idx < MAX_N_AXIS; idx++) {
+                new_work_offset[idx] = gc_state.work_offset[idx] - gc_state.coord_system[idx] + new_coord_system[idx];
+            }
+            block_coord_system = new_coord_system;
+            block_work_offset  = new_work_offset;
         }
     }
     // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
@@ -899,15 +1126,39 @@ Error gc_execute_line(char* line, uint8_t client) {
     // all the current coordinate system and G92 offsets.
     switch (gc_block.non_modal_command) {
         case NonModal::SetCoordinateData:
-            // [G10 Errors]: L missing and is not 2 or 20. P word missing. (Negative P value done.)
-            // [G10 L2 Errors]: R word NOT SUPPORTED. P value not 0 to nCoordSys(max 9). Axis words missing.
-            // [G10 L20 Errors]: P must be 0 to nCoordSys(max 9). Axis words missing.
+            // [G10 Errors]: L missing and is not 1, 2, 10 or 20. P word missing. (Negative P value done.)
+            // [G10 L1/L10 Errors]: P value not a tool of the table. Axis words other than the tool length axis.
+            // [G10 L2 Errors]: R word NOT SUPPORTED. P value not 0 to nCoordSys(max 9) or a fixture. Axis words missing.
+            // [G10 L20 Errors]: P must be 0 to nCoordSys(max 9) or a fixture. Axis words missing.
+            //   NOTE: P7 and up are the fixtures of G54.1, P7 being G54.1 P1.
             if (!axis_words) {
                 FAIL(Error::GcodeNoAxisWords)
             };  // [No axis words]
             if (bit_isfalse(value_words, (bit(GCodeWord::P) | bit(GCodeWord::L)))) {
                 FAIL(Error::GcodeValueWordMissing);  // [P/L word missing]
             }
+            if ((gc_block.values.l == 10 || gc_block.values.l == 20) && gc_state.work_transformed) {
+                FAIL(Error::GcodeUnsupportedCommand);  // [G10 L10/L20 with G51 or G68 active]
+            }
+            if (gc_block.values.l == 1 || gc_block.values.l == 10) {
+                if (gc_block.values.p < 1.0 || gc_block.values.p >= N_TOOL_TABLE + 1) {
+                    FAIL(Error::GcodeMaxValueExceeded);  // [Tool not in the table]
+                }
+                if (axis_words ^ bit(TOOL_LENGTH_OFFSET_AXIS)) {
+                    FAIL(Error::GcodeG43DynamicAxisError);
+                }
+                bit_false(value_words, (bit(GCodeWord::L) | bit(GCodeWord::P)));
+                gc_block.values.h = trunc(gc_block.values.p);
+                if (gc_block.values.l == 10) {
+                    // L10: The length with which the current position is the programmed value
+                    // WPos = MPos - WCS - G92 - TLO  ->  TLO = MPos - WCS - G92 - WPos
+                    gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS] = gc_state.position[TOOL_LENGTH_OFFSET_AXIS] -
+                                                                   block_coord_system[TOOL_LENGTH_OFFSET_AXIS] -
+                                                                   gc_state.coord_offset[TOOL_LENGTH_OFFSET_AXIS] -
+                                                                   gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS];
+                }
+                break;
+            }
             if (gc_block.values.l != 20) {
                 if (gc_block.values.l == 2) {
                     if (bit_istrue(value_words, bit(GCodeWord::R))) {
@@ -918,19 +1169,26 @@ Error gc_execute_line(char* line, uint8_t client) {
                 }
             }
             // Select the coordinate system based on the P word
+            if (gc_block.values.p >= CoordIndex::NWCSystems + N_FIXTURE_TABLE + 1) {
+                FAIL(Error::GcodeUnsupportedCoordSys);  // [Greater than N sys and fixtures]
+            }
             pValue = trunc(gc_block.values.p);  // Convert p value to integer
-            if (pValue > 0) {
+            if (pValue > CoordIndex::NWCSystems) {
+                // P7 means G54.1 P1, etc.
+                fixture = pValue - CoordIndex::NWCSystems;
+            } else if (pValue > 0) {
                 // P1 means G54, P2 means G55, etc.
                 coord_select = static_cast<CoordIndex>(pValue - 1 + CoordIndex::G54);
             } else {
                 // P0 means use currently-selected system
                 coord_select = gc_block.modal.coord_select;
+                fixture      = gc_block.modal.fixture;
             }
             if (coord_select >= CoordIndex::NWCSystems) {
                 FAIL(Error::GcodeUnsupportedCoordSys);  // [Greater than N sys]
             }
             bit_false(value_words, (bit(GCodeWord::L) | bit(GCodeWord::P)));
-            coords[coord_select]->get(coord_data);
+            gc_get_coord_system(coord_select, fixture, coord_data);
 
             // Pre-calculate the coordinate data changes.
             for (idx = 0; idx < n_axis; idx++) {  // Axes indices are consistent, so loop may be used.
@@ -955,6 +1213,9 @@ Error gc_execute_line(char* line, uint8_t client) {
             if (!axis_words) {
                 FAIL(Error::GcodeNoAxisWords);  // [No axis words]
             }
+            if (gc_state.work_transformed) {
+                FAIL(Error::GcodeUnsupportedCommand);  // [G92 with G51 or G68 active]
+            }
             // Update axes defined only in block. Offsets current system to defined value. Does not update when
             // active coordinate system is selected, but is still active unless G92.1 disables it.
             for (idx = 0; idx < n_axis; idx++) {  // Axes indices are consistent, so loop may be used.
@@ -969,6 +1230,33 @@ Error gc_execute_line(char* line, uint8_t client) {
                 }
             }
             break;
+        case NonModal::SetRotation:
+            // [G68 Errors]: R word missing. Plane is not XY.
+            // NOTE: X Y is the center, in work coordinates. An axis that is not given is 0.
+            if (bit_isfalse(value_words, bit(GCodeWord::R))) {
+                FAIL(Error::GcodeValueWordMissing);  // [R word missing]
+            }
+            if (gc_block.modal.plane_select != Plane::XY) {
+                FAIL(Error::GcodeUnsupportedCommand);  // [Rotation only in G17]
+            }
+            bit_false(value_words, bit(GCodeWord::R));
+            break;
+        case NonModal::SetScaling:
+            // [G51 Errors]: No P, I, J or K word. A scale factor is not positive.
+            // NOTE: X Y Z is the center, in work coordinates. P scales all three axes, I J K one each.
+            if (bit_isfalse(value_words, bit(GCodeWord::P)) && !ijk_words) {
+                FAIL(Error::GcodeValueWordMissing);  // [P, I, J or K word missing]
+            }
+            for (idx = X_AXIS; idx <= Z_AXIS; idx++) {
+                if (bit_isfalse(ijk_words, bit(idx))) {
+                    gc_block.values.ijk[idx] = bit_istrue(value_words, bit(GCodeWord::P)) ? gc_block.values.p : 1.0f;
+                }
+                if (gc_block.values.ijk[idx] <= 0.0f) {
+                    FAIL(Error::NegativeValue);  // [Mirroring not supported]
+                }
+            }
+            bit_false(value_words, (bit(GCodeWord::P) | bit(GCodeWord::I) | bit(GCodeWord::J) | bit(GCodeWord::K)));
+            break;
         default:
             // At this point, the rest of the explicit axis commands treat the axis values as the traditional
             // target position with the coordinate system offsets, G92 offsets, absolute override, and distance
@@ -976,6 +1264,13 @@ Error gc_execute_line(char* line, uint8_t client) {
             // NOTE: Tool offsets may be appended to these conversions when/if this feature is added.
             if (axis_command != AxisCommand::ToolLengthOffset) {  // TLO block any axis command.
                 if (axis_words) {
+                    // With G51 or G68, X Y Z are worked out in work coordinates and transformed together.
+                    bool  transform = gc_state.work_transformed && gc_block.non_modal_command != NonModal::AbsoluteOverride &&
+                                      (axis_words & (bit(X_AXIS) | bit(Y_AXIS) | bit(Z_AXIS)));
+                    float work[MAX_N_AXIS];
+                    if (transform) {
+                        gc_machine_to_work(gc_state.position, block_work_offset, work);
+                    }
                     for (idx = 0; idx < n_axis; idx++) {  // Axes indices are consistent, so loop may be used to save flash space.
                         if (bit_isfalse(axis_words, bit(idx))) {
                             gc_block.values.xyz[idx] = gc_state.position[idx];  // No axis word in block. Keep same axis position.
@@ -983,18 +1278,32 @@ Error gc_execute_line(char* line, uint8_t client) {
                             // Update specified value according to distance mode or ignore if absolute override is active.
                             // NOTE: G53 is never active with G28/30 since they are in the same modal group.
                             if (gc_block.non_modal_command != NonModal::AbsoluteOverride) {
-                                // Apply coordinate offsets based on distance mode.
-                                if (gc_block.modal.distance == Distance::Absolute) {
-                                    gc_block.values.xyz[idx] += block_coord_system[idx] + gc_state.coord_offset[idx];
-                                    if (idx == TOOL_LENGTH_OFFSET_AXIS) {
-                                        gc_block.values.xyz[idx] += gc_state.tool_length_offset;
+                                if (transform && idx <= Z_AXIS) {
+                                    if (gc_block.modal.distance == Distance::Incremental) {
+                                        gc_block.values.xyz[idx] += work[idx];
                                     }
+                                    work[idx] = gc_block.values.xyz[idx];
+                                } else if (gc_block.modal.distance == Distance::Absolute) {
+                                    // Apply coordinate offsets based on distance mode.
+                                    gc_block.values.xyz[idx] += block_work_offset[idx];
                                 } else {  // Incremental mode
                                     gc_block.values.xyz[idx] += gc_state.position[idx];
                                 }
                             }
                         }
                     }
+                    if (transform) {
+                        // Axes that are not moved by the words keep their exact position
+                        float machine[MAX_N_AXIS];
+                        gc_work_to_machine(work, block_work_offset, machine);
+                        if (axis_words & (bit(X_AXIS) | bit(Y_AXIS))) {
+                            gc_block.values.xyz[X_AXIS] = machine[X_AXIS];
+                            gc_block.values.xyz[Y_AXIS] = machine[Y_AXIS];
+                        }
+                        if (axis_words & bit(Z_AXIS)) {
+                            gc_block.values.xyz[Z_AXIS] = machine[Z_AXIS];
+                        }
+                    }
                 }
             }
             // Check remaining non-modal commands for errors.
@@ -1058,7 +1367,8 @@ Error gc_execute_line(char* line, uint8_t client) {
             // the value must be positive. In inverse time mode, a positive value must be passed with each block.
         } else {
             // Check if feed rate is defined for the motion modes that require it.
-            if (gc_block.values.f == 0.0) {
+            // Spindle synchronized motion takes its rate from the spindle.
+            if (gc_block.values.f == 0.0 && gc_block.modal.motion != Motion::SpindleSync && gc_block.modal.motion != Motion::RigidTap) {
                 FAIL(Error::GcodeUndefinedFeedRate);  // [Feed rate undefined]
             }
             switch (gc_block.modal.motion) {
@@ -1088,6 +1398,11 @@ Error gc_execute_line(char* line, uint8_t client) {
                     if (!(axis_words & (bit(axis_0) | bit(axis_1)))) {
                         FAIL(Error::GcodeNoAxisWordsInPlane);  // [No axis words in plane]
                     }
+                    // G68 turns only the XY plane. G51 must scale both axes of the plane alike, or the arc is an ellipse.
+                    if ((gc_state.rotated && gc_block.modal.plane_select != Plane::XY) ||
+                        gc_state.work_scale[axis_0] != gc_state.work_scale[axis_1]) {
+                        FAIL(Error::GcodeUnsupportedCommand);  // [Arc not in the transformed plane]
+                    }
                     // Calculate the change in position along each selected axis
                     float x, y;
                     x = gc_block.values.xyz[axis_0] - gc_state.position[axis_0];  // Delta x between current position and target
@@ -1101,6 +1416,7 @@ Error gc_execute_line(char* line, uint8_t client) {
                         if (gc_block.modal.units == Units::Inches) {
                             gc_block.values.r *= MM_PER_INCH;
                         }
+                        gc_block.values.r *= gc_state.work_scale[axis_0];
                         /*  We need to calculate the center of the circle that has the designated radius and passes
                         through both the current position and the target position. This method calculates the following
                         set of equations where [x,y] is the vector from current to target position, d == magnitude of
@@ -1199,6 +1515,14 @@ Error gc_execute_line(char* line, uint8_t client) {
                                 }
                             }
                         }
+                        // The offsets are turned and scaled like the target, without the work offset
+                        if (gc_state.work_transformed) {
+                            float i                     = gc_block.values.ijk[X_AXIS] * gc_state.work_scale[X_AXIS];
+                            float j                     = gc_block.values.ijk[Y_AXIS] * gc_state.work_scale[Y_AXIS];
+                            gc_block.values.ijk[X_AXIS] = i * gc_state.work_cos - j * gc_state.work_sin;
+                            gc_block.values.ijk[Y_AXIS] = i * gc_state.work_sin + j * gc_state.work_cos;
+                            gc_block.values.ijk[Z_AXIS] *= gc_state.work_scale[Z_AXIS];
+                        }
                         // Arc radius from center to target
                         x -= gc_block.values.ijk[axis_0];  // Delta x between circle center and target
                         y -= gc_block.values.ijk[axis_1];  // Delta y between circle center and target
@@ -1217,6 +1541,134 @@ Error gc_execute_line(char* line, uint8_t client) {
                         }
                     }
                     break;
+                case Motion::SpindleSync:
+                    // [G33 Errors]: No spindle encoder. Spindle off. K word missing or not positive. No axis words.
+                    if (!spindle_encoder_present()) {
+                        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "No spindle encoder");
+                        FAIL(Error::GcodeUnsupportedCommand);
+                    }
+                    if (gc_block.modal.spindle == SpindleState::Disable) {
+                        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Spindle is off");
+                        FAIL(Error::GcodeUnsupportedCommand);
+                    }
+                    if (bit_isfalse(value_words, bit(GCodeWord::K))) {
+                        FAIL(Error::GcodeValueWordMissing);  // [K word missing]
+                    }
+                    if (gc_block.values.ijk[Z_AXIS] <= 0.0) {
+                        FAIL(Error::NegativeValue);
+                    }
+                    bit_false(value_words, bit(GCodeWord::K));
+                    if (gc_block.modal.units == Units::Inches) {
+                        gc_block.values.ijk[Z_AXIS] *= MM_PER_INCH;  // The pitch
+                    }
+                    if (!axis_words) {
+                        FAIL(Error::GcodeNoAxisWords);  // [No axis words]
+                    }
+                    break;
+                case Motion::ChipBreakDrill:
+                case Motion::Drill:
+                case Motion::DrillDwell:
+                case Motion::PeckDrill:
+                case Motion::RigidTap: {
+                    // [Canned cycle Errors]: Plane not G17. Inverse time feed. No axis words. R or Z word missing
+                    //   and not retained from an earlier block of the same cycle mode. Z not below R.
+                    // [G73/G83 Errors]: Q word missing or not positive. [G82 Errors]: P word missing.
+                    // [G84 Errors]: No spindle encoder. Spindle not M3. K word missing or not positive.
+                    // NOTE: R, Z, Q, P and K are retained while a canned cycle mode is active. L is the number
+                    //   of repeats and is not retained. L0 only stores the words.
+                    if (gc_block.modal.plane_select != Plane::XY || gc_block.modal.feed_rate == FeedRate::InverseTime) {
+                        FAIL(Error::GcodeUnsupportedCommand);  // [Not along Z, or G93]
+                    }
+                    if (!axis_words) {
+                        FAIL(Error::GcodeNoAxisWords);  // [No axis words, the hole would be at X0 Y0]
+                    }
+                    const uint32_t cycle_words = bit(GCodeWord::R) | bit(GCodeWord::Q) | bit(GCodeWord::P) | bit(GCodeWord::K);
+                    canned_words               = value_words & cycle_words;
+                    if (bit_istrue(axis_words, bit(Z_AXIS))) {
+                        canned_words |= bit(GCodeWord::Z);
+                    }
+                    uint32_t retained = is_canned_cycle(gc_state.modal.motion) ? gc_state.canned.words : 0;
+                    bit_false(retained, canned_words);
+                    canned_words |= retained;
+                    if (bit_isfalse(value_words, bit(GCodeWord::L))) {
+                        gc_block.values.l = 1;
+                    }
+                    bit_false(value_words, cycle_words | bit(GCodeWord::L));
+                    if (bit_isfalse(canned_words, bit(GCodeWord::R)) || bit_isfalse(canned_words, bit(GCodeWord::Z))) {
+                        FAIL(Error::GcodeValueWordMissing);  // [R or Z word missing]
+                    }
+                    // R is a Z level: in work coordinates, or relative to the start with G91.
+                    // With G91, Z is relative to R. Retained levels are in work coordinates,
+                    // so they follow a change of the work offset.
+                    float z_offset = gc_state.work_shift[Z_AXIS] + block_work_offset[Z_AXIS];
+                    if (bit_istrue(retained, bit(GCodeWord::R))) {
+                        gc_block.values.r = gc_state.canned.r_level + z_offset;
+                    } else {
+                        if (gc_block.modal.units == Units::Inches) {
+                            gc_block.values.r *= MM_PER_INCH;
+                        }
+                        gc_block.values.r *= gc_state.work_scale[Z_AXIS];  // G51
+                        if (gc_block.modal.distance == Distance::Absolute) {
+                            gc_block.values.r += z_offset;
+                        } else {
+                            gc_block.values.r += gc_state.position[Z_AXIS];
+                        }
+                    }
+                    if (bit_istrue(retained, bit(GCodeWord::Z))) {
+                        gc_block.values.xyz[Z_AXIS] = gc_state.canned.z_bottom + z_offset;
+                    } else if (gc_block.modal.distance == Distance::Incremental) {
+                        gc_block.values.xyz[Z_AXIS] += gc_block.values.r - gc_state.position[Z_AXIS];
+                    }
+                    if (gc_block.values.xyz[Z_AXIS] >= gc_block.values.r) {
+                        FAIL(Error::GcodeInvalidTarget);  // [Bottom not below R]
+                    }
+                    if (bit_istrue(retained, bit(GCodeWord::Q))) {
+                        gc_block.values.q = gc_state.canned.q;
+                    } else if (gc_block.modal.units == Units::Inches) {
+                        gc_block.values.q *= MM_PER_INCH;
+                    }
+                    if (bit_istrue(retained, bit(GCodeWord::P))) {
+                        gc_block.values.p = gc_state.canned.p;
+                    }
+                    if (bit_istrue(retained, bit(GCodeWord::K))) {
+                        gc_block.values.ijk[Z_AXIS] = gc_state.canned.pitch;
+                    } else if (gc_block.modal.units == Units::Inches) {
+                        gc_block.values.ijk[Z_AXIS] *= MM_PER_INCH;
+                    }
+                    switch (gc_block.modal.motion) {
+                        case Motion::ChipBreakDrill:
+                        case Motion::PeckDrill:
+                            if (bit_isfalse(canned_words, bit(GCodeWord::Q))) {
+                                FAIL(Error::GcodeValueWordMissing);  // [Q word missing]
+                            }
+                            if (gc_block.values.q <= 0.0) {
+                                FAIL(Error::NegativeValue);
+                            }
+                            break;
+                        case Motion::DrillDwell:
+                            if (bit_isfalse(canned_words, bit(GCodeWord::P))) {
+                                FAIL(Error::GcodeValueWordMissing);  // [P word missing]
+                            }
+                            break;
+                        case Motion::RigidTap:
+                            if (!spindle_encoder_present()) {
+                                grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "No spindle encoder");
+                                FAIL(Error::GcodeUnsupportedCommand);
+                            }
+                            if (gc_block.modal.spindle != SpindleState::Cw) {
+                                FAIL(Error::GcodeUnsupportedCommand);  // [Spindle off, or left hand tapping]
+                            }
+                            if (bit_isfalse(canned_words, bit(GCodeWord::K))) {
+                                FAIL(Error::GcodeValueWordMissing);  // [K word missing]
+                            }
+                            if (gc_block.values.ijk[Z_AXIS] <= 0.0) {
+                                FAIL(Error::NegativeValue);
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                } break;
                 case Motion::ProbeTowardNoError:
                 case Motion::ProbeAwayNoError:
                     gc_parser_flags |= GCParserProbeIsNoError;  // No break intentional.
@@ -1323,6 +1775,14 @@ Error gc_execute_line(char* line, uint8_t client) {
     gc_state.line_number = gc_block.values.n;
 #ifdef USE_LINE_NUMBERS
     pl_data->line_number = gc_state.line_number;  // Record data for planner use.
+#endif
+#ifdef LINE_TIMING
+    // N numbers repeat, or are not given at all, so the lines are told apart by this count
+    static uint32_t line_index = 0;
+    if (++line_index == 0) {
+        line_index = 1;
+    }
+    pl_data->line_index = line_index;
 #endif
     // [1. Comments feedback ]:  NOT SUPPORTED
     // [2. Set feed rate mode ]:
@@ -1334,7 +1794,18 @@ Error gc_execute_line(char* line, uint8_t client) {
     gc_state.feed_rate = gc_block.values.f;   // Always copy this value. See feed rate error-checking.
     pl_data->feed_rate = gc_state.feed_rate;  // Record data for planner use.
     // [4. Set spindle speed ]:
-    if ((gc_state.spindle_speed != gc_block.values.s) || bit_istrue(gc_parser_flags, GCParserLaserForceSync)) {
+    // With G96, the spindle speed follows the X radius in the step segments, without a sync per line.
+    gc_state.modal.spindle_speed_mode = gc_block.modal.spindle_speed_mode;
+    if (gc_state.modal.spindle_speed_mode == SpindleSpeedMode::SurfaceSpeed) {
+        gc_state.surface_speed     = surface_speed;
+        gc_state.max_spindle_speed = gc_block.values.d;
+        gc_state.spindle_speed     = gc_block.values.s;
+#ifdef CONSTANT_SURFACE_SPEED
+        pl_data->surface_speed     = surface_speed;
+        pl_data->max_spindle_speed = gc_block.values.d;
+        pl_data->spindle_axis_x    = gc_state.work_offset[X_AXIS];
+#endif
+    } else if ((gc_state.spindle_speed != gc_block.values.s) || bit_istrue(gc_parser_flags, GCParserLaserForceSync)) {
         if (gc_state.modal.spindle != SpindleState::Disable) {
             if (bit_isfalse(gc_parser_flags, GCParserLaserIsMotion)) {
                 if (bit_istrue(gc_parser_flags, GCParserLaserDisable)) {
@@ -1352,9 +1823,14 @@ Error gc_execute_line(char* line, uint8_t client) {
     }                                                     // else { pl_data->spindle_speed = 0.0; } // Initialized as zero already.
     // [5. Select tool ]: NOT SUPPORTED. Only tracks tool value.
     //	gc_state.tool = gc_block.values.t;
-    // [6. Change tool ]: NOT SUPPORTED
+    // [6. Change tool ]: Only with a user tool change
     if (gc_block.modal.tool_change == ToolChange::Enable) {
-#ifdef USE_TOOL_CHANGE
+#ifdef USE_QUEUED_TOOL_CHANGE
+        plan_line_data_t tool_change_data = *pl_data;
+        tool_change_data.spindle          = gc_state.modal.spindle;
+        tool_change_data.coolant          = gc_state.modal.coolant;
+        mc_tool_change(gc_state.tool, &tool_change_data, gc_state.position);
+#elif defined(USE_TOOL_CHANGE)
         user_tool_change(gc_state.tool);
 #endif
     }
@@ -1431,25 +1907,28 @@ Error gc_execute_line(char* line, uint8_t client) {
     gc_state.modal.units = gc_block.modal.units;
     // [13. Cutter radius compensation ]: G41/42 NOT SUPPORTED
     // gc_state.modal.cutter_comp = gc_block.modal.cutter_comp; // NOTE: Not needed since always disabled.
-    // [14. Cutter length compensation ]: G43.1 and G49 supported. G43 NOT SUPPORTED.
-    // NOTE: If G43 were supported, its operation wouldn't be any different from G43.1 in terms
-    // of execution. The error-checking step would simply load the offset value into the correct
-    // axis of the block XYZ value array.
+    // [14. Cutter length compensation ]: G43, G43.1 and G49 supported.
+    // NOTE: G43 is no different from G43.1 in terms of execution. The error-checking step has
+    // loaded the length from the tool table into the correct axis of the block XYZ value array.
     if (axis_command == AxisCommand::ToolLengthOffset) {  // Indicates a change.
         gc_state.modal.tool_length = gc_block.modal.tool_length;
+        gc_state.tool_length_tool  = gc_state.modal.tool_length == ToolLengthOffset::EnableTable ? gc_block.values.h : 0;
         if (gc_state.modal.tool_length == ToolLengthOffset::Cancel) {  // G49
             gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS] = 0.0;
         }
-        // else G43.1
+        // else G43 or G43.1
         if (gc_state.tool_length_offset != gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS]) {
             gc_state.tool_length_offset = gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS];
+            gc_update_work_offset();
             system_flag_wco_change();
         }
     }
     // [15. Coordinate system selection ]:
-    if (gc_state.modal.coord_select != gc_block.modal.coord_select) {
+    if (gc_state.modal.coord_select != gc_block.modal.coord_select || gc_state.modal.fixture != gc_block.modal.fixture) {
         gc_state.modal.coord_select = gc_block.modal.coord_select;
+        gc_state.modal.fixture      = gc_block.modal.fixture;
         memcpy(gc_state.coord_system, block_coord_system, sizeof(gc_state.coord_system));
+        gc_update_work_offset();
         system_flag_wco_change();
     }
     // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
@@ -1460,10 +1939,25 @@ Error gc_execute_line(char* line, uint8_t client) {
     // [19. Go to predefined position, Set G10, or Set axis offsets ]:
     switch (gc_block.non_modal_command) {
         case NonModal::SetCoordinateData:
-            coords[coord_select]->set(coord_data);
+            if (gc_block.values.l == 1 || gc_block.values.l == 10) {
+                offset_table->setToolLength(gc_block.values.h, gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS]);
+                // Update the tool length offset if G43 uses this tool.
+                if (gc_state.tool_length_tool == gc_block.values.h) {
+                    gc_state.tool_length_offset = gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS];
+                    gc_update_work_offset();
+                    system_flag_wco_change();
+                }
+                break;
+            }
+            if (fixture) {
+                offset_table->setFixture(fixture, coord_data);
+            } else {
+                coords[coord_select]->set(coord_data);
+            }
             // Update system coordinate system if currently active.
-            if (gc_state.modal.coord_select == coord_select) {
+            if (gc_state.modal.coord_select == coord_select && gc_state.modal.fixture == fixture) {
                 memcpy(gc_state.coord_system, coord_data, sizeof(gc_state.coord_system));
+                gc_update_work_offset();
                 system_flag_wco_change();
             }
             break;
@@ -1486,15 +1980,44 @@ Error gc_execute_line(char* line, uint8_t client) {
             break;
         case NonModal::SetCoordinateOffset:
             memcpy(gc_state.coord_offset, gc_block.values.xyz, sizeof(gc_block.values.xyz));
+            gc_update_work_offset();
             system_flag_wco_change();
             break;
         case NonModal::ResetCoordinateOffset:
             clear_vector(gc_state.coord_offset);  // Disable G92 offsets by zeroing offset vector.
+            gc_update_work_offset();
+            system_flag_wco_change();
+            break;
+        case NonModal::SetRotation:
+            gc_state.rotated                 = true;
+            gc_state.rotation_center[X_AXIS] = gc_block.values.xyz[X_AXIS];
+            gc_state.rotation_center[Y_AXIS] = gc_block.values.xyz[Y_AXIS];
+            gc_state.rotation                = gc_block.values.r;
+            gc_update_work_offset();
+            system_flag_wco_change();
+            break;
+        case NonModal::CancelRotation:
+            gc_state.rotated = false;
+            gc_update_work_offset();
+            system_flag_wco_change();
+            break;
+        case NonModal::SetScaling:
+            gc_state.scaled = true;
+            memcpy(gc_state.scale_center, gc_block.values.xyz, sizeof(gc_state.scale_center));
+            memcpy(gc_state.scale, gc_block.values.ijk, sizeof(gc_state.scale));
+            gc_update_work_offset();
+            system_flag_wco_change();
+            break;
+        case NonModal::CancelScaling:
+            gc_state.scaled = false;
+            gc_update_work_offset();
             system_flag_wco_change();
             break;
         default:
             break;
     }
+    // [19a. Canned cycle return mode ]: G98/G99 take effect with the cycles of this block.
+    gc_state.modal.retract = gc_block.modal.retract;
     // [20. Motion modes ]:
     // NOTE: Commands G10,G28,G30,G92 lock out and prevent axis words from use in motion modes.
     // Enter motion modes only if there are axis words or a motion mode command word in the block.
@@ -1509,6 +2032,41 @@ Error gc_execute_line(char* line, uint8_t client) {
                 pl_data->motion.rapidMotion = 1;  // Set rapid motion flag.
                 //mc_line(gc_block.values.xyz, pl_data);
                 mc_line_kins(gc_block.values.xyz, pl_data, gc_state.position);
+#ifdef SPINDLE_SYNC
+            } else if (gc_state.modal.motion == Motion::SpindleSync) {
+                mc_spindle_sync(gc_block.values.xyz, pl_data, gc_block.values.ijk[Z_AXIS]);
+#endif
+            } else if (is_canned_cycle(gc_state.modal.motion)) {
+                // The levels are kept in work Z, and the cycle runs with them in machine Z
+                float z_offset           = gc_state.work_shift[Z_AXIS] + block_work_offset[Z_AXIS];
+                gc_state.canned.words    = canned_words;
+                gc_state.canned.r_level  = gc_block.values.r - z_offset;
+                gc_state.canned.z_bottom = gc_block.values.xyz[Z_AXIS] - z_offset;
+                gc_state.canned.q        = gc_block.values.q;
+                gc_state.canned.p        = gc_block.values.p;
+                gc_state.canned.pitch    = gc_block.values.ijk[Z_AXIS];
+                canned_cycle_t cycle     = gc_state.canned;
+                cycle.r_level            = gc_block.values.r;
+                cycle.z_bottom           = gc_block.values.xyz[Z_AXIS];
+                // G98 returns to the Z level the cycle was started from, G99 to R.
+                float retract_level = gc_block.values.r;
+                if (gc_state.modal.retract == RetractMode::InitialLevel) {
+                    retract_level = MAX(retract_level, gc_state.position[Z_AXIS]);
+                }
+                // With G91, every repeat of L moves on by the X and Y increments.
+                float position[MAX_N_AXIS], hole[MAX_N_AXIS], step[MAX_N_AXIS];
+                memcpy(position, gc_state.position, sizeof(position));
+                memcpy(hole, gc_block.values.xyz, sizeof(hole));
+                for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+                    step[idx] = (gc_block.modal.distance == Distance::Incremental && idx != Z_AXIS) ? hole[idx] - position[idx] : 0.0;
+                }
+                for (uint8_t i = 0; i < gc_block.values.l && !sys.abort; i++) {
+                    mc_canned_cycle(gc_state.modal.motion, hole, pl_data, position, &cycle, retract_level);
+                    for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+                        hole[idx] += step[idx];
+                    }
+                }
+                memcpy(gc_block.values.xyz, position, sizeof(position));  // Over the last hole, at the retract level
             } else if ((gc_state.modal.motion == Motion::CwArc) || (gc_state.modal.motion == Motion::CcwArc)) {
                 mc_arc(gc_block.values.xyz,
                        pl_data,
@@ -1569,6 +2127,7 @@ Error gc_execute_line(char* line, uint8_t client) {
             gc_state.modal.feed_rate    = FeedRate::UnitsPerMin;
             // gc_state.modal.cutter_comp = CutterComp::Disable; // Not supported.
             gc_state.modal.coord_select = CoordIndex::G54;
+            gc_state.modal.fixture      = 0;
             gc_state.modal.spindle      = SpindleState::Disable;
             gc_state.modal.coolant      = {};
 #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
@@ -1587,6 +2146,7 @@ Error gc_execute_line(char* line, uint8_t client) {
             // Execute coordinate change and spindle/coolant stop.
             if (sys.state != State::CheckMode) {
                 coords[gc_state.modal.coord_select]->get(gc_state.coord_system);
+                gc_update_work_offset();
                 system_flag_wco_change();  // Set to refresh immediately just in case something altered.
                 spindle->set_state(SpindleState::Disable, 0);
                 coolant_off();
@@ -32,16 +32,16 @@
 // NOTE: Modal group values must be sequential and starting from zero.
 
 enum class ModalGroup : uint8_t {
-    MG0  = 0,   // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-    MG1  = 1,   // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+    MG0  = 0,   // [G4,G10,G28,G28.1,G30,G30.1,G50,G51,G53,G68,G69,G92,G92.1] Non-modal
+    MG1  = 1,   // [G0,G1,G2,G3,G33,G38.2,G38.3,G38.4,G38.5,G73,G80,G81,G82,G83,G84] Motion
     MG2  = 2,   // [G17,G18,G19] Plane selection
     MG3  = 3,   // [G90,G91] Distance mode
     MG4  = 4,   // [G91.1] Arc IJK distance mode
     MG5  = 5,   // [G93,G94] Feed rate mode
     MG6  = 6,   // [G20,G21] Units
     MG7  = 7,   // [G40] Cutter radius compensation mode. G41/42 NOT SUPPORTED.
-    MG8  = 8,   // [G43.1,G49] Tool length offset
-    MG12 = 9,   // [G54,G55,G56,G57,G58,G59] Coordinate system selection
+    MG8  = 8,   // [G43,G43.1,G49] Tool length offset
+    MG12 = 9,   // [G54,G54.1,G55,G56,G57,G58,G59] Coordinate system selection
     MG13 = 10,  // [G61] Control mode
     MM4  = 11,  // [M0,M1,M2,M30] Stopping
     MM6  = 14,  // [M6] Tool change
@@ -49,6 +49,8 @@ enum class ModalGroup : uint8_t {
     MM8  = 13,  // [M7,M8,M9] Coolant control
     MM9  = 14,  // [M56] Override control
     MM10 = 15,  // [M62, M63, M64, M65, M67, M68] User Defined http://linuxcnc.org/docs/html/gcode/overview.html#_modal_groups
+    MG10 = 16,  // [G98,G99] Canned cycle return mode
+    MG14 = 17,  // [G96,G97] Spindle speed mode
 };
 
 // Command actions for within execution-type modal groups (motion, stopping, non-modal). Used
@@ -71,6 +73,10 @@ enum class NonModal : uint8_t {
     AbsoluteOverride      = 53,   // G53 (Do not alter value)
     SetCoordinateOffset   = 92,   // G92 (Do not alter value)
     ResetCoordinateOffset = 102,  //G92.1 (Do not alter value)
+    CancelScaling         = 50,   // G50
+    SetScaling            = 51,   // G51
+    SetRotation           = 68,   // G68
+    CancelRotation        = 69,   // G69
 };
 
 // Modal Group G1: Motion modes
@@ -83,6 +89,12 @@ enum class Motion : uint8_t {
     ProbeTowardNoError = 141,  // G38.3 (Do not alter value)
     ProbeAway          = 142,  // G38.4 (Do not alter value)
     ProbeAwayNoError   = 143,  // G38.5 (Do not alter value)
+    SpindleSync        = 33,   // G33
+    ChipBreakDrill     = 73,   // G73
+    Drill              = 81,   // G81
+    DrillDwell         = 82,   // G82
+    PeckDrill          = 83,   // G83
+    RigidTap           = 84,   // G84
     None               = 80,   // G80 (Do not alter value)
 };
 
@@ -105,6 +117,12 @@ enum class ArcDistance : uint8_t {
     Absolute    = 1,
 };
 
+// Modal Group G10: Canned cycle return mode
+enum class RetractMode : uint8_t {
+    InitialLevel = 0,  // G98 (Default: Must be zero)
+    RLevel       = 1,  // G99
+};
+
 // Modal Group M4: Program flow
 enum class ProgramFlow : uint8_t {
     Running      = 0,   // (Default: Must be zero)
@@ -137,6 +155,12 @@ enum class ControlMode : uint8_t {
     ExactPath = 0,  // G61 (Default: Must be zero)
 };
 
+// Modal Group G14: Spindle speed mode
+enum class SpindleSpeedMode : uint8_t {
+    Rpm          = 0,  // G97 (Default: Must be zero)
+    SurfaceSpeed = 1,  // G96
+};
+
 // Modal Group M7: Spindle control
 enum class SpindleState : uint8_t {
     Disable = 0,  // M5 (Default: Must be zero)
@@ -180,6 +204,7 @@ static const int MaxUserDigitalPin = 4;
 enum class ToolLengthOffset : uint8_t {
     Cancel        = 0,  // G49 (Default: Must be zero)
     EnableDynamic = 1,  // G43.1
+    EnableTable   = 2,  // G43
 };
 
 enum class ToolChange : uint8_t {
@@ -188,7 +213,7 @@ enum class ToolChange : uint8_t {
 };
 
 // Modal Group G12: Active work coordinate system
-// N/A: Stores coordinate system value (54-59) to change to.
+// N/A: Stores coordinate system value (54-59) to change to, and the fixture of G54.1.
 
 // Parameter word mapping.
 enum class GCodeWord : uint8_t {
@@ -210,6 +235,8 @@ enum class GCodeWord : uint8_t {
     A = 15,
     B = 16,
     C = 17,
+    H = 18,
+    D = 19,
 };
 
 // GCode parser position updating flags
@@ -234,27 +261,32 @@ enum GCParserFlags {
 
 // NOTE: When this struct is zeroed, the 0 values in the above types set the system defaults.
 typedef struct {
-    Motion   motion;     // {G0,G1,G2,G3,G38.2,G80}
+    Motion   motion;     // {G0,G1,G2,G3,G33,G38.2,G73,G80,G81,G82,G83,G84}
     FeedRate feed_rate;  // {G93,G94}
     Units    units;      // {G20,G21}
     Distance distance;   // {G90,G91}
     // ArcDistance distance_arc; // {G91.1} NOTE: Don't track. Only default supported.
     Plane plane_select;  // {G17,G18,G19}
     // CutterCompensation cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
-    ToolLengthOffset tool_length;   // {G43.1,G49}
+    ToolLengthOffset tool_length;   // {G43,G43.1,G49}
     CoordIndex       coord_select;  // {G54,G55,G56,G57,G58,G59}
+    uint8_t          fixture;       // {G54.1 P1-P50}, 0 with G54-G59
     // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
-    ProgramFlow  program_flow;  // {M0,M1,M2,M30}
-    CoolantState coolant;       // {M7,M8,M9}
-    SpindleState spindle;       // {M3,M4,M5}
-    ToolChange   tool_change;   // {M6}
-    IoControl    io_control;    // {M62, M63, M67}
-    Override     override;      // {M56}
+    RetractMode      retract;             // {G98,G99}
+    SpindleSpeedMode spindle_speed_mode;  // {G96,G97}
+    ProgramFlow      program_flow;        // {M0,M1,M2,M30}
+    CoolantState     coolant;             // {M7,M8,M9}
+    SpindleState     spindle;             // {M3,M4,M5}
+    ToolChange       tool_change;         // {M6}
+    IoControl        io_control;          // {M62, M63, M67}
+    Override         override;            // {M56}
 } gc_modal_t;
 
 typedef struct {
+    float   d;                // G96 spindle speed limit
     uint8_t e;                // M67
     float   f;                // Feed
+    uint8_t h;                // G43 tool length offset number
     float   ijk[3];           // I,J,K Axis arc offsets - only 3 are possible
     uint8_t l;                // G10 or canned cycles parameters
     int32_t n;                // Line number
@@ -266,13 +298,25 @@ typedef struct {
     float   xyz[MAX_N_AXIS];  // X,Y,Z Translational axes
 } gc_values_t;
 
+// Canned cycle words are kept from block to block, until the motion mode changes to a non-cycle one.
+typedef struct {
+    uint32_t words;     // GCodeWord bits of the values below that have been given
+    float    r_level;   // R, work Z in mm
+    float    z_bottom;  // Z, work Z in mm
+    float    q;         // G73/G83 peck depth in mm
+    float    p;         // G82 dwell in seconds
+    float    pitch;     // G84 thread pitch (K) in mm per revolution
+} canned_cycle_t;
+
 typedef struct {
     gc_modal_t modal;
 
-    float   spindle_speed;  // RPM
-    float   feed_rate;      // Millimeters/min
-    uint8_t tool;           // Tracks tool number. NOT USED.
-    int32_t line_number;    // Last line number sent
+    float   spindle_speed;      // RPM
+    float   surface_speed;      // G96 cutting speed at the tool, mm/min
+    float   max_spindle_speed;  // G96 spindle speed limit, RPM
+    float   feed_rate;          // Millimeters/min
+    uint8_t tool;               // Tracks tool number. NOT USED.
+    int32_t line_number;        // Last line number sent
 
     float position[MAX_N_AXIS];  // Where the interpreter considers the tool to be at this point in the code
 
@@ -281,6 +325,27 @@ typedef struct {
     float coord_offset[MAX_N_AXIS];  // Retains the G92 coordinate offset (work coordinates) relative to
     // machine zero in mm. Non-persistent. Cleared upon reset and boot.
     float tool_length_offset;  // Tracks tool length offset value when enabled.
+    float work_offset[MAX_N_AXIS];  // The sum of the three above, work to machine position in mm. Rebuilt by
+    // gc_update_work_offset() when one of them changes, so the parser and reports do not add them up every time.
+
+    uint8_t tool_length_tool;  // Tool table entry of the tool length offset with G43, 0 otherwise
+
+    bool  rotated;             // G68 is active
+    float rotation_center[2];  // G68 X Y, work coordinates in mm
+    float rotation;            // G68 R, degrees counterclockwise
+    bool  scaled;              // G51 is active
+    float scale_center[3];     // G51 X Y Z, work coordinates in mm
+    float scale[3];            // G51 P, or I J K for each axis
+
+    // The G51 scaling and G68 rotation, rebuilt along with work_offset. X, Y and Z work coordinates are
+    // scaled by work_scale, rotated by work_sin and work_cos, and moved by work_shift before work_offset.
+    bool  work_transformed;  // Rotation or scaling is active
+    float work_scale[3];
+    float work_sin;
+    float work_cos;
+    float work_shift[3];  // mm
+
+    canned_cycle_t canned;  // Words retained by G73, G81, G82, G83 and G84
 } parser_state_t;
 extern parser_state_t gc_state;
 
@@ -306,3 +371,13 @@ Error gc_execute_line(char* line, uint8_t client);
 
 // Set g-code parser position. Input in steps.
 void gc_sync_position();
+
+// Rebuild gc_state.work_offset from the coordinate system, G92 and tool length offsets,
+// and the G51/G68 transform from the scaling and rotation
+void gc_update_work_offset();
+
+// Work coordinates to machine coordinates, with the rotation and scaling and the given work offset
+void gc_work_to_machine(const float* work, const float* offset, float* machine);
+
+// Machine coordinates to work coordinates. work may be the same array as machine.
+void gc_machine_to_work(const float* machine, const float* offset, float* work);
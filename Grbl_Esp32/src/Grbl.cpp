@@ -41,6 +41,9 @@ void grbl_init() {
     stepper_init();   // Configure stepper pins and interrupt timers
     init_motors();
     system_ini();  // Configure pinout pins and pin-change interrupt (Renamed due to conflict with esp32 files)
+#ifdef PLANNER_TASK
+    planner_task_init();
+#endif
     memset(sys_position, 0, sizeof(sys_position));  // Clear machine position.
 
 #ifdef USE_MACHINE_INIT
@@ -66,6 +69,11 @@ void grbl_init() {
     }
 #endif
     Spindles::Spindle::select();
+    spindle_encoder_init();
+    axis_encoder_init();
+#ifdef SIMULATED_INPUTS
+    sim_inputs_init();
+#endif
 #ifdef ENABLE_WIFI
     WebUI::wifi_config.begin();
 #endif
@@ -78,9 +86,13 @@ void grbl_init() {
 static void reset_variables() {
     // Reset system variables.
     State prior_state = sys.state;
+#ifdef PLANNER_TASK
+    planner_task_reset();  // While sys.abort keeps the task from planning
+#endif
     memset(&sys, 0, sizeof(system_t));  // Clear system struct variable.
     sys.state             = prior_state;
     sys.f_override        = FeedOverride::Default;              // Set to 100%
+    sys.f_adaptive        = FeedOverride::Default;              // Set to 100%
     sys.r_override        = RapidOverride::Default;             // Set to 100%
     sys.spindle_speed_ovr = SpindleSpeedOverride::Default;      // Set to 100%
     memset(sys_probe_position, 0, sizeof(sys_probe_position));  // Clear probe position.
@@ -106,6 +118,10 @@ static void reset_variables() {
     // Sync cleared gcode and planner positions to current system position.
     plan_sync_position();
     gc_sync_position();
+    axis_encoder_sync();
+#ifdef SIMULATED_INPUTS
+    sim_inputs_sync();
+#endif
     report_init_message(CLIENT_ALL);
 }
 
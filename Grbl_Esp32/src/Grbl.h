@@ -49,6 +49,7 @@ const char* const GRBL_VERSION_BUILD = "20201101";
 
 #include "GCode.h"
 #include "Planner.h"
+#include "PlannerTask.h"
 #include "CoolantControl.h"
 #include "Limits.h"
 #include "MotionControl.h"
@@ -57,8 +58,16 @@ const char* const GRBL_VERSION_BUILD = "20201101";
 #include "Serial.h"
 #include "Pins.h"
 #include "Spindles/Spindle.h"
+#include "SpindleEncoder.h"
+#include "AxisEncoder.h"
+#include "SimulatedInputs.h"
 #include "Motors/Motors.h"
 #include "Stepper.h"
+#include "ProfileTrace.h"
+#include "LineTiming.h"
+#include "OutputScheduler.h"
+#include "InputShaper.h"
+#include "AdaptiveFeed.h"
 #include "Jog.h"
 #include "WebUI/InputBuffer.h"
 #include "Settings.h"
@@ -117,3 +126,8 @@ void user_m30();
 
 // Called if USE_TOOL_CHANGE is defined
 void user_tool_change(uint8_t new_tool);
+
+// Called if USE_QUEUED_TOOL_CHANGE is defined. Fill moves with the tool change sequence and
+// return how many there are. moves has room for capacity moves. A longer sequence does not fit,
+// so return 0 for it, after reporting it, rather than writing past the end.
+uint8_t user_tool_change_moves(uint8_t new_tool, tool_change_move_t* moves, uint8_t capacity);
@@ -127,6 +127,15 @@ static int i2s_out_initialized = 0;
 static volatile uint32_t             i2s_out_pulse_period;
 static uint32_t                      i2s_out_remain_time_until_next_pulse;  // Time remaining until the next pulse (μsec)
 static volatile i2s_out_pulse_func_t i2s_out_pulse_func;
+
+// DMA progress, used by i2s_out_delay() to wait until a written word has been
+// clocked out instead of sleeping for the worst case with the pulser locked.
+// The buffers are sent in the same order they are filled, so the counters can
+// be compared directly.
+static volatile uint32_t     i2s_out_dma_filled_count = 0;        // Buffers handed to the DMA
+static volatile uint32_t     i2s_out_dma_sent_count   = 0;        // Buffers the DMA has finished sending
+static volatile uint32_t     i2s_out_delay_watermark  = 0;        // i2s_out_dma_sent_count that ends the wait
+static volatile TaskHandle_t i2s_out_delay_task       = nullptr;  // Task blocked in i2s_out_delay()
 #endif
 
 static uint8_t i2s_out_ws_pin   = 255;
@@ -216,8 +225,19 @@ static int IRAM_ATTR i2s_clear_o_dma_buffers(uint32_t port_data) {
         o_dma.desc[buf_idx]->qe.stqe_next = (lldesc_t*)((buf_idx < (I2S_OUT_DMABUF_COUNT - 1)) ? (o_dma.desc[buf_idx + 1]) : o_dma.desc[0]);
         i2s_clear_dma_buffer(o_dma.desc[buf_idx], port_data);
     }
+    // Every buffer in the ring now holds port_data
+    i2s_out_dma_filled_count = i2s_out_dma_sent_count + I2S_OUT_DMABUF_COUNT;
     return 0;
 }
+
+// Detach the task waiting in i2s_out_delay(), if any, so it can be notified.
+// Call with the I2S_OUT_PULSER lock acquired, and notify the returned task
+// after the lock is released.
+static TaskHandle_t IRAM_ATTR i2s_out_release_delay() {
+    TaskHandle_t task  = i2s_out_delay_task;
+    i2s_out_delay_task = nullptr;
+    return task;
+}
 #endif
 
 static int IRAM_ATTR i2s_out_gpio_attach(uint8_t ws, uint8_t bck, uint8_t data) {
@@ -455,6 +475,7 @@ static void IRAM_ATTR i2s_out_intr_handler(void* arg) {
             if (i2s_out_pulser_status == STEPPING) {
                 port_data = atomic_load(&i2s_out_port_data);
             }
+            i2s_out_dma_filled_count++;  // i2sOutTask counts its buffers under the same lock
             I2S_OUT_PULSER_EXIT_CRITICAL_ISR();
             for (int i = 0; i < DMA_SAMPLE_COUNT; i++) {
                 front_desc->buf[i] = port_data;
@@ -462,6 +483,18 @@ static void IRAM_ATTR i2s_out_intr_handler(void* arg) {
             front_desc->length = I2S_OUT_DMABUF_LEN;
         }
 
+        // Release i2s_out_delay() once the buffer it is waiting for has been sent
+        TaskHandle_t delay_task = nullptr;
+        I2S_OUT_PULSER_ENTER_CRITICAL_ISR();
+        i2s_out_dma_sent_count++;
+        if ((int32_t)(i2s_out_dma_sent_count - i2s_out_delay_watermark) >= 0) {
+            delay_task = i2s_out_release_delay();
+        }
+        I2S_OUT_PULSER_EXIT_CRITICAL_ISR();
+        if (delay_task != nullptr) {
+            vTaskNotifyGiveFromISR(delay_task, &high_priority_task_awoken);
+        }
+
         // Send a DMA complete event to the I2S bitstreamer task with finished buffer
         xQueueSendFromISR(o_dma.queue, &finish_desc, &high_priority_task_awoken);
     }
@@ -478,12 +511,14 @@ static void IRAM_ATTR i2s_out_intr_handler(void* arg) {
 // I2S bitstream generator task
 //
 static void IRAM_ATTR i2sOutTask(void* parameter) {
-    lldesc_t* dma_desc;
+    lldesc_t*    dma_desc;
+    TaskHandle_t delay_task;
     while (1) {
         // Wait a DMA complete event from I2S isr
         // (Block until a DMA transfer has complete)
         xQueueReceive(o_dma.queue, &dma_desc, portMAX_DELAY);
         o_dma.current = (uint32_t*)(dma_desc->buf);
+        delay_task    = nullptr;
         // It reuses the oldest (just transferred) buffer with the name "current"
         // and fills the buffer for later DMA.
         I2S_OUT_PULSER_ENTER_CRITICAL();  // Lock pulser status
@@ -500,6 +535,7 @@ static void IRAM_ATTR i2sOutTask(void* parameter) {
             //
             i2s_fillout_dma_buffer(dma_desc);
             dma_desc->length = o_dma.rw_pos * I2S_SAMPLE_SIZE;
+            i2s_out_dma_filled_count++;
         } else if (i2s_out_pulser_status == WAITING) {
             if (dma_desc->qe.stqe_next == NULL) {
                 // Tail of the DMA descriptor found
@@ -510,6 +546,8 @@ static void IRAM_ATTR i2sOutTask(void* parameter) {
                 // because the process in i2s_out_start() is different depending on the status.
                 i2s_out_pulser_status = PASSTHROUGH;
                 i2s_out_start();
+                // The port data is output directly from now on
+                delay_task = i2s_out_release_delay();
             } else {
                 // Processing a buffer slightly ahead of the tail buffer.
                 // We don't need to fill up the buffer by port_data any more.
@@ -524,6 +562,9 @@ static void IRAM_ATTR i2sOutTask(void* parameter) {
             o_dma.rw_pos = 0;                   // If someone calls i2s_out_push_sample, make sure there is no buffer overflow
         }
         I2S_OUT_PULSER_EXIT_CRITICAL();  // Unlock pulser status
+        if (delay_task != nullptr) {
+            xTaskNotifyGive(delay_task);
+        }
 
         static UBaseType_t uxHighWaterMark = 0;
         reportTaskStackSize(uxHighWaterMark);
@@ -536,16 +577,42 @@ static void IRAM_ATTR i2sOutTask(void* parameter) {
 //
 void IRAM_ATTR i2s_out_delay() {
 #ifdef USE_I2S_OUT_STREAM_IMPL
+    if (!xPortInIsrContext()) {
+        ulTaskNotifyTake(pdTRUE, 0);  // Discard a notification left over from a timed out wait
+    }
     I2S_OUT_PULSER_ENTER_CRITICAL();
     if (i2s_out_pulser_status == PASSTHROUGH) {
+        I2S_OUT_PULSER_EXIT_CRITICAL();
         // Depending on the timing, it may not be reflected immediately,
         // so wait twice as long just in case.
         ets_delay_us(I2S_OUT_USEC_PER_PULSE * 2);
-    } else {
-        // Just wait until the data now registered in the DMA descripter
-        // is reflected in the I2S TX module via FIFO.
+        return;
+    }
+    if (i2s_out_delay_task != nullptr || xPortInIsrContext()) {
+        // Someone else is already waiting (or we cannot block).
+        // Fall back to waiting for the worst case.
+        I2S_OUT_PULSER_EXIT_CRITICAL();
         delay(I2S_OUT_DELAY_MS);
+        return;
+    }
+    // The data written so far is copied into the next buffer to be filled.
+    // Wait until the DMA has sent that buffer, or until the pulser has gone
+    // back to passthrough mode, where the data is output directly.
+    if (i2s_out_pulser_status == WAITING) {
+        // The stream is draining and no longer picks up the port data.
+        // Only the switch to passthrough can release the wait.
+        i2s_out_delay_watermark = i2s_out_dma_sent_count + INT32_MAX;
+    } else {
+        i2s_out_delay_watermark = i2s_out_dma_filled_count + 1;
     }
+    i2s_out_delay_task = xTaskGetCurrentTaskHandle();
+    I2S_OUT_PULSER_EXIT_CRITICAL();
+
+    // The timeout keeps the old worst case if the DMA stops unexpectedly.
+    ulTaskNotifyTake(pdTRUE, I2S_OUT_DELAY_MS / portTICK_PERIOD_MS + 1);
+
+    I2S_OUT_PULSER_ENTER_CRITICAL();
+    i2s_out_delay_task = nullptr;
     I2S_OUT_PULSER_EXIT_CRITICAL();
 #else
     ets_delay_us(I2S_OUT_USEC_PER_PULSE * 2);
@@ -570,6 +637,21 @@ void IRAM_ATTR i2s_out_write(uint8_t pin, uint8_t val) {
 #endif
 }
 
+void IRAM_ATTR i2s_out_write_bits(uint32_t set_bits, uint32_t clear_bits) {
+    uint_least32_t port_data = atomic_load(&i2s_out_port_data);
+    // Retry until no other writer has changed the port data in between.
+    // On failure, port_data is reloaded with the current value.
+    while (!atomic_compare_exchange_weak(&i2s_out_port_data, &port_data, (port_data & ~clear_bits) | set_bits)) {}
+#ifdef USE_I2S_OUT_STREAM_IMPL
+    // Same unlocked access as in i2s_out_write().
+    if (i2s_out_pulser_status == PASSTHROUGH) {
+        i2s_out_single_data();
+    }
+#else
+    i2s_out_single_data();
+#endif
+}
+
 uint8_t IRAM_ATTR i2s_out_read(uint8_t pin) {
     uint32_t port_data = atomic_load(&i2s_out_port_data);
     return (!!(port_data & bit(pin)));
@@ -683,6 +765,9 @@ int IRAM_ATTR i2s_out_set_pulse_callback(i2s_out_pulse_func_t func) {
 }
 
 int IRAM_ATTR i2s_out_reset() {
+#ifdef USE_I2S_OUT_STREAM_IMPL
+    TaskHandle_t delay_task = nullptr;
+#endif
     I2S_OUT_PULSER_ENTER_CRITICAL();
     i2s_out_stop();
 #ifdef USE_I2S_OUT_STREAM_IMPL
@@ -692,12 +777,18 @@ int IRAM_ATTR i2s_out_reset() {
     } else if (i2s_out_pulser_status == WAITING) {
         i2s_clear_o_dma_buffers(0);
         i2s_out_pulser_status = PASSTHROUGH;
+        delay_task            = i2s_out_release_delay();
     }
 #endif
     // You need to set the status before calling i2s_out_start()
     // because the process in i2s_out_start() is different depending on the status.
     i2s_out_start();
     I2S_OUT_PULSER_EXIT_CRITICAL();
+#ifdef USE_I2S_OUT_STREAM_IMPL
+    if (delay_task != nullptr) {
+        xTaskNotifyGive(delay_task);
+    }
+#endif
     return 0;
 }
 
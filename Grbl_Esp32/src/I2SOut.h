@@ -121,6 +121,17 @@ uint8_t i2s_out_read(uint8_t pin);
 */
 void i2s_out_write(uint8_t pin, uint8_t val);
 
+/*
+   Set and clear several bits in the internal pin state var at once.
+   (not written electrically)
+   The update is a single atomic operation, so it is much cheaper
+   than calling i2s_out_write() for every pin when many outputs
+   change together, e.g. the step or direction pins of all axes.
+   set_bits:   bit mask of expanded pins to set
+   clear_bits: bit mask of expanded pins to clear
+ */
+void i2s_out_write_bits(uint32_t set_bits, uint32_t clear_bits);
+
 /*
     Set current pin state to the I2S bitstream buffer
     (This call will generate a future I2S_OUT_USEC_PER_PULSE μs x N bitstream)
@@ -152,6 +163,10 @@ int i2s_out_set_stepping();
 /*
   Dynamically delay until the Shift Register Pin changes
   according to the current I2S processing state and mode.
+  In stream mode, the calling task blocks until the DMA
+  reports that the buffer carrying the current pin state
+  has been sent, or the pulser has switched to passthrough.
+  I2S_OUT_DELAY_MS is only the upper bound of the wait.
  */
 void i2s_out_delay();
 
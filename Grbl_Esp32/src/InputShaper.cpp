@@ -0,0 +1,272 @@
+/*
+  InputShaper.cpp - per axis input shaping of the step stream
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
+// The ISR does not use the FPU, so the impulses are kept in fixed point.
+typedef struct {
+    uint8_t  n_impulses;
+    uint32_t amplitude[SHAPER_MAX_IMPULSES];  // Q16, the sum is exactly 1 << 16
+    uint32_t delay[SHAPER_MAX_IMPULSES];      // ticks, delay[0] is always 0
+} shaper_axis_t;
+
+typedef struct {
+    uint32_t time;
+    int32_t  position[MAX_N_AXIS];
+} shaper_knot_t;
+
+static shaper_axis_t shaper[MAX_N_AXIS];
+static uint8_t       shaped_axes      = 0;
+static uint32_t      shaper_max_delay = 0;
+
+static shaper_knot_t knots[SHAPER_KNOTS];
+static uint8_t       knot_head  = 0;  // Newest knot
+static uint8_t       knot_count = 0;
+
+static uint32_t shaper_now;                     // Wraps after 214 sec, only differences are used
+static int32_t  shaper_command[MAX_N_AXIS];     // Unshaped position, as the planner asked for it
+static int32_t  shaper_output_pos[MAX_N_AXIS];  // Position that has been put out to the motors
+
+static volatile uint32_t shaper_late_ticks = 0;  // Ticks the output was off the settled commanded position
+
+static const char* shaper_names[] = { "None", "ZV", "ZVD", "EI" };
+
+void shaper_init() {
+    uint8_t  axes      = 0;
+    uint32_t max_delay = 0;
+    auto     n_axis    = number_axis->get();
+
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        auto  type = axis < n_axis ? static_cast<ShaperType>(axis_settings[axis]->shaper_type->get()) : ShaperType::None;
+        float freq = axis_settings[axis]->shaper_frequency->get();
+        float zeta = axis_settings[axis]->shaper_damping->get();
+
+        // Impulses for the damped resonance, before normalizing
+        float df = sqrtf(1.0f - zeta * zeta);
+        float K  = expf(-zeta * float(M_PI) / df);
+        float td = 1.0f / (freq * df);  // Damped period in sec
+
+        float a[SHAPER_MAX_IMPULSES] = { 1.0f };
+        float t[SHAPER_MAX_IMPULSES] = { 0.0f };
+        int   n                      = 1;
+        switch (type) {
+            case ShaperType::ZV:
+                n    = 2;
+                a[1] = K;
+                t[1] = 0.5f * td;
+                break;
+            case ShaperType::ZVD:
+                n    = 3;
+                a[1] = 2.0f * K;
+                a[2] = K * K;
+                t[1] = 0.5f * td;
+                t[2] = td;
+                break;
+            case ShaperType::EI: {
+                const float v_tol = 0.05f;  // Tolerated residual vibration
+                n                 = 3;
+                a[0]              = 0.25f * (1.0f + v_tol);
+                a[1]              = 0.5f * (1.0f - v_tol) * K;
+                a[2]              = a[0] * K * K;
+                t[1]              = 0.5f * td;
+                t[2]              = td;
+            } break;
+            default:
+                break;
+        }
+
+        float sum = 0.0f;
+        for (int i = 0; i < n; i++) {
+            sum += a[i];
+        }
+        shaper_axis_t s;
+        memset(&s, 0, sizeof(s));  // For the memcmp below
+        uint32_t rest = 1 << 16;
+        for (int i = n - 1; i > 0; i--) {
+            s.amplitude[i] = lroundf(a[i] / sum * (1 << 16));
+            s.delay[i]     = t[i] * fStepperTimer;
+            rest -= s.amplitude[i];
+        }
+        s.amplitude[0] = rest;  // Rounding goes here, so the shaped position always ends up on the commanded one
+        s.delay[0]     = 0;
+        s.n_impulses   = n;
+
+        if (n > 1) {
+            axes |= bit(axis);
+            max_delay = MAX(max_delay, s.delay[n - 1]);
+            if (memcmp(&s, &shaper[axis], sizeof(s)) != 0) {
+                grbl_msg_sendf(CLIENT_SERIAL,
+                               MsgLevel::Info,
+                               "%s shaper %s %.1fHz: %.3f@0ms %.3f@%.1fms %.3f@%.1fms",
+                               axis_settings[axis]->name,
+                               shaper_names[int(type)],
+                               double(freq),
+                               s.amplitude[0] / 65536.0,
+                               s.amplitude[1] / 65536.0,
+                               s.delay[1] * 1000.0 / fStepperTimer,
+                               n > 2 ? s.amplitude[2] / 65536.0 : 0.0,
+                               n > 2 ? s.delay[2] * 1000.0 / fStepperTimer : 0.0);
+            }
+        }
+        shaper[axis] = s;
+    }
+
+    // Homing needs the switches to trip where the steps are
+    shaped_axes      = sys.state == State::Homing ? 0 : axes;
+    shaper_max_delay = max_delay;
+    shaper_reset();
+}
+
+void shaper_reset() {
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        shaper_command[axis] = shaper_output_pos[axis];
+    }
+    knot_count = 0;
+}
+
+uint8_t IRAM_ATTR shaper_axes() {
+    return shaped_axes;
+}
+
+void IRAM_ATTR shaper_advance(uint32_t ticks) {
+    shaper_now += ticks;
+}
+
+void IRAM_ATTR shaper_command_step(uint8_t axis, bool negative) {
+    shaper_command[axis] += negative ? -1 : 1;
+}
+
+void IRAM_ATTR shaper_knot() {
+    knot_head = (knot_head + 1) % SHAPER_KNOTS;
+    if (knot_count < SHAPER_KNOTS) {
+        knot_count++;
+    }
+    knots[knot_head].time = shaper_now;
+    memcpy(knots[knot_head].position, shaper_command, sizeof(shaper_command));
+}
+
+// The commanded position of an axis at a past time, in Q16 steps.
+// It is linear between knots, and from the newest knot to now.
+static int64_t IRAM_ATTR shaper_command_at(uint8_t axis, uint32_t time) {
+    uint32_t t1 = shaper_now;
+    int32_t  p1 = shaper_command[axis];
+    uint8_t  k  = knot_head;
+    for (uint8_t n = 0; n < knot_count; n++) {
+        uint32_t t0 = knots[k].time;
+        int32_t  p0 = knots[k].position[axis];
+        if ((int32_t)(time - t0) >= 0) {
+            uint32_t span = t1 - t0;
+            uint32_t dt   = time - t0;
+            if (p0 == p1 || span == 0) {
+                return (int64_t)p0 << 16;
+            }
+            // Scale the times down so the fraction fits a 32 bit division
+            if (span > 0xffff) {
+                int shift = 16 - __builtin_clz(span);
+                span >>= shift;
+                dt >>= shift;
+            }
+            uint32_t frac = (dt << 16) / span;  // Q16
+            return ((int64_t)p0 << 16) + (int64_t)(p1 - p0) * frac;
+        }
+        t1 = t0;
+        p1 = p0;
+        k  = k == 0 ? SHAPER_KNOTS - 1 : k - 1;
+    }
+    return (int64_t)p1 << 16;  // Older than the history, use the oldest position known
+}
+
+uint8_t IRAM_ATTR shaper_output(uint8_t& dir_bits, uint8_t* step_bits, uint8_t max_steps) {
+    int32_t target[MAX_N_AXIS];
+    // Once the last impulse has passed the newest knot and the command has not moved since,
+    // the shaped position is the commanded one.
+    bool settled = knot_count > 0 && shaper_now - knots[knot_head].time >= shaper_max_delay;
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        if (!bitnum_istrue(shaped_axes, axis)) {
+            continue;
+        }
+        shaper_axis_t* s      = &shaper[axis];
+        int64_t        shaped = (int64_t)s->amplitude[0] * ((int64_t)shaper_command[axis] << 16);  // Q32
+        for (uint8_t i = 1; i < s->n_impulses; i++) {
+            shaped += (int64_t)s->amplitude[i] * shaper_command_at(axis, shaper_now - s->delay[i]);
+        }
+        target[axis] = (shaped + (1LL << 31)) >> 32;
+        if (target[axis] > shaper_output_pos[axis]) {
+            dir_bits &= ~bit(axis);
+        } else if (target[axis] < shaper_output_pos[axis]) {
+            dir_bits |= bit(axis);
+        }
+        if (shaper_command[axis] != knots[knot_head].position[axis]) {
+            settled = false;
+        }
+    }
+
+    uint8_t n_steps = 0;
+    for (; n_steps < max_steps; n_steps++) {
+        uint8_t bits = 0;
+        for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+            if (!bitnum_istrue(shaped_axes, axis)) {
+                continue;
+            }
+            if (target[axis] > shaper_output_pos[axis]) {
+                shaper_output_pos[axis]++;
+                bits |= bit(axis);
+            } else if (target[axis] < shaper_output_pos[axis]) {
+                shaper_output_pos[axis]--;
+                bits |= bit(axis);
+            }
+        }
+        if (bits == 0) {
+            break;
+        }
+        step_bits[n_steps] = bits;
+    }
+
+    if (settled) {
+        for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+            if (bitnum_istrue(shaped_axes, axis) && shaper_output_pos[axis] != shaper_command[axis]) {
+                shaper_late_ticks++;
+                break;
+            }
+        }
+    }
+    return n_steps;
+}
+
+bool IRAM_ATTR shaper_busy() {
+    if (knot_count > 0 && shaper_now - knots[knot_head].time < shaper_max_delay) {
+        return true;
+    }
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        if (bitnum_istrue(shaped_axes, axis) && shaper_output_pos[axis] != shaper_command[axis]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void shaper_report_late() {
+    if (shaper_late_ticks) {
+        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Shaped axes ended %d ticks late", shaper_late_ticks);
+        shaper_late_ticks = 0;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+  InputShaper.h - per axis input shaping of the step stream
+  Part of Grbl_ESP32
+
+  An input shaper convolves the commanded position of an axis with a few
+  impulses, timed so that the vibration each impulse excites in a
+  resonance of the machine is cancelled by the next ones:
+
+    ZV   2 impulses over half a period of the resonance
+    ZVD  3 impulses over a full period, less sensitive to a wrong frequency
+    EI   3 impulses over a full period, tolerating 5% residual vibration
+
+  The stepper ISR counts the commanded (unshaped) steps of the shaped axes
+  into shaper_command_step() and records a knot at the start of every
+  segment. Between knots the commanded position is linear in time, so the
+  delayed impulses read it back by interpolation. shaper_output() then
+  returns the step bits that move the axes towards the shaped position.
+  The delayed impulses can replay a faster part of the move than the
+  ISR is running now, so an axis can be more than one step behind. All
+  the steps that are due go out in the same tick, as a burst of pulses
+  after the first one, as many as fit in the tick.
+
+  Times are in ticks of fStepperTimer, positions in steps.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+
+enum class ShaperType : int8_t {
+    None = 0,
+    ZV,
+    ZVD,
+    EI,
+};
+
+const int SHAPER_MAX_IMPULSES = 3;
+const int SHAPER_KNOTS        = 32;  // Segment history. Must span the longest shaper.
+const int SHAPER_MAX_BURST    = 4;   // Step pulses per ISR tick
+
+// ISR period while the shaped axes finish after the segment buffer has run empty
+const uint16_t SHAPER_DRAIN_TICKS = fStepperTimer / 20000;
+
+// Read the shaper settings. Only call while the stepper ISR is stopped.
+void shaper_init();
+
+// Forget the history; the commanded position becomes the output position.
+void shaper_reset();
+
+// Bit mask of the axes that are shaped
+uint8_t shaper_axes();
+
+// Advance the shaper clock by the period of the ISR tick that has just passed
+void shaper_advance(uint32_t ticks);
+
+// Count one commanded step of a shaped axis
+void shaper_command_step(uint8_t axis, bool negative);
+
+// Record the commanded position at the start of a segment
+void shaper_knot();
+
+// Step bits towards the shaped position, one mask per pulse, at most max_steps of them. The steps
+// that do not fit are put out in the next tick. The direction of the shaped axes is updated in dir_bits.
+// Returns the number of masks.
+uint8_t shaper_output(uint8_t& dir_bits, uint8_t* step_bits, uint8_t max_steps);
+
+// True while the output has not yet caught up with the commanded position
+bool shaper_busy();
+
+// The shaped axes must end a move on the tick the last impulse passes its end, as the
+// shaped position is the commanded one from then on. Reports the ticks they ended late.
+void shaper_report_late();
@@ -43,6 +43,9 @@ Error jog_execute(plan_line_data_t* pl_data, parser_block_t* gc_block) {
 #else  // else use kinematics
     inverse_kinematics(gc_block->values.xyz, pl_data, gc_state.position);
 #endif
+#ifdef PLANNER_TASK
+    planner_task_synchronize();
+#endif
 
     if (sys.state == State::Idle) {
         if (plan_get_current_block() != NULL) {  // Check if there is a block to execute.
@@ -152,12 +152,15 @@ void limits_go_home(uint8_t cycle_mask) {
         homing_rate *= sqrt(n_active_axis);  // [sqrt(number of active axis)] Adjust so individual axes all move at homing rate.
         sys.homing_axis_lock = axislock;
         // Perform homing cycle. Planner buffer should be empty, as required to initiate the homing cycle.
-        pl_data->feed_rate = homing_rate;   // Set current homing rate.
-        plan_buffer_line(target, pl_data);  // Bypass mc_line(). Directly plan homing motion.
-        sys.step_control                  = {};
-        sys.step_control.executeSysMotion = true;  // Set to execute homing motion and clear existing flags.
-        st_prep_buffer();                          // Prep and fill segment buffer from newly planned block.
-        st_wake_up();                              // Initiate motion
+        pl_data->feed_rate = homing_rate;  // Set current homing rate.
+        {
+            PlannerLock lock;
+            plan_buffer_line(target, pl_data);  // Bypass mc_line(). Directly plan homing motion.
+            sys.step_control                  = {};
+            sys.step_control.executeSysMotion = true;  // Set to execute homing motion and clear existing flags.
+            st_prep_buffer();                          // Prep and fill segment buffer from newly planned block.
+        }
+        st_wake_up();  // Initiate motion
         do {
             if (approach) {
                 // Check limit state. Lock out cycle axes when they change.
@@ -208,7 +211,7 @@ void limits_go_home(uint8_t cycle_mask) {
 #ifdef USE_I2S_STEPS
         if (current_stepper == ST_I2S_STREAM) {
             if (!approach) {
-                delay_ms(I2S_OUT_DELAY_MS);
+                i2s_out_delay();  // Wait for the queued step pulses to be sent
             }
         }
 #endif
@@ -248,6 +251,7 @@ void limits_go_home(uint8_t cycle_mask) {
             }
         }
     }
+    axis_encoder_sync();                        // The encoders are compared from the homed position on
     sys.step_control = {};                      // Return step control to normal operation.
     motors_set_homing_mode(cycle_mask, false);  // tell motors homing is done
 }
@@ -329,6 +333,9 @@ AxisMask limits_get_state() {
 
 #ifdef INVERT_LIMIT_PIN_MASK  // not normally used..unless you have both normal and inverted switches
     pinMask ^= INVERT_LIMIT_PIN_MASK;
+#endif
+#ifdef SIMULATED_INPUTS
+    pinMask |= sim_inputs_limits() & ((1 << n_axis) - 1);
 #endif
     return pinMask;
 }
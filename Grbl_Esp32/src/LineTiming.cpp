@@ -0,0 +1,200 @@
+/*
+  LineTiming.cpp - time taken by each g-code line against its programmed feed rate
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#ifdef LINE_TIMING
+
+struct LineTime {
+    uint32_t line_index;
+    int32_t  line_number;
+    uint32_t programmed_us;
+    uint32_t actual_us;
+};
+
+// Written by the stepper ISR
+static LineTime          recent[LINE_TIMING_LINES];
+static uint16_t          recent_head  = 0;  // Next to write
+static uint16_t          recent_count = 0;
+static LineTime          worst[LINE_TIMING_WORST];  // Most time lost first
+static uint8_t           worst_count = 0;
+static volatile uint32_t n_lines     = 0;
+static volatile uint32_t n_slow      = 0;
+static volatile uint64_t total_programmed_us;
+static volatile uint64_t total_actual_us;
+static portMUX_TYPE      totals_spinlock = portMUX_INITIALIZER_UNLOCKED;  // The totals are 64 bits, read from a task
+
+static LineTime current;  // The line that is running
+static bool     running       = false;
+static bool     stopped       = false;  // The time of current is not running
+static bool     untimed       = false;  // A block that is not from a g-code line is running
+static uint32_t last_sequence = 0;      // Planner block whose programmed time was counted last
+static int64_t  start_time;             // Of the running part of current
+
+static int32_t IRAM_ATTR time_lost(const LineTime& l) {
+    return l.actual_us - l.programmed_us;
+}
+
+static void IRAM_ATTR line_timing_close() {
+    recent[recent_head] = current;
+    recent_head         = (recent_head + 1) % LINE_TIMING_LINES;
+    if (recent_count < LINE_TIMING_LINES) {
+        recent_count++;
+    }
+    portENTER_CRITICAL_ISR(&totals_spinlock);
+    n_lines++;
+    total_programmed_us += current.programmed_us;
+    total_actual_us += current.actual_us;
+    if (uint64_t(current.programmed_us) * 100 < uint64_t(current.actual_us) * LINE_TIMING_SLOW_PERCENT) {
+        n_slow++;
+    }
+    portEXIT_CRITICAL_ISR(&totals_spinlock);
+
+    // Insertion into the worst lines, by the time lost
+    int32_t lost = time_lost(current);
+    uint8_t n    = worst_count;
+    if (n == LINE_TIMING_WORST) {
+        if (lost <= time_lost(worst[n - 1])) {
+            return;
+        }
+        n--;  // The last one drops out
+    } else {
+        worst_count++;
+    }
+    while (n > 0 && lost > time_lost(worst[n - 1])) {
+        worst[n] = worst[n - 1];
+        n--;
+    }
+    worst[n] = current;
+}
+
+void IRAM_ATTR line_timing_block(uint32_t line_index, int32_t line_number, uint32_t sequence, uint32_t programmed_us) {
+    int64_t now = esp_timer_get_time();
+    untimed     = line_index == 0;
+    if (untimed) {
+        line_timing_stop(false);
+        return;
+    }
+    if (sequence == last_sequence) {
+        programmed_us = 0;  // Resumed after parking, or the next chord of an arc
+    }
+    last_sequence = sequence;
+    if (running) {
+        if (line_index == current.line_index) {
+            current.programmed_us += programmed_us;
+            if (stopped) {
+                start_time = now;
+                stopped    = false;
+            }
+            return;
+        }
+        if (!stopped) {
+            current.actual_us += now - start_time;
+        }
+        line_timing_close();
+    }
+    current.line_index    = line_index;
+    current.line_number   = line_number;
+    current.programmed_us = programmed_us;
+    current.actual_us     = 0;
+    start_time            = now;
+    running               = true;
+    stopped               = false;
+}
+
+void IRAM_ATTR line_timing_segment() {
+    if (stopped && !untimed) {
+        start_time = esp_timer_get_time();
+        stopped    = false;
+    }
+}
+
+void IRAM_ATTR line_timing_stop(bool end) {
+    if (running && !stopped) {
+        current.actual_us += esp_timer_get_time() - start_time;
+        stopped = true;
+    }
+    if (running && end) {
+        line_timing_close();
+        running = false;
+    }
+}
+
+void line_timing_clear() {
+    recent_count = 0;
+    worst_count  = 0;
+    portENTER_CRITICAL(&totals_spinlock);
+    n_lines             = 0;
+    n_slow              = 0;
+    total_programmed_us = 0;
+    total_actual_us     = 0;
+    portEXIT_CRITICAL(&totals_spinlock);
+}
+
+static int line_percent(uint64_t programmed_us, uint64_t actual_us) {
+    return actual_us ? int(programmed_us * 100 / actual_us) : 100;
+}
+
+void line_timing_report(WebUI::ESPResponseStream* out, bool all) {
+    if (all) {
+        char     line[64];
+        uint16_t count = recent_count;
+        uint16_t first = (recent_head + LINE_TIMING_LINES - count) % LINE_TIMING_LINES;
+        out->println("#line,programmed_ms,actual_ms,percent");
+        for (uint16_t i = 0; i < count; i++) {
+            const LineTime& l = recent[(first + i) % LINE_TIMING_LINES];
+            snprintf(line,
+                     sizeof(line),
+                     "%d,%.1f,%.1f,%d",
+                     l.line_number,
+                     l.programmed_us / 1000.0,
+                     l.actual_us / 1000.0,
+                     line_percent(l.programmed_us, l.actual_us));
+            out->println(line);
+        }
+        return;
+    }
+
+    portENTER_CRITICAL(&totals_spinlock);
+    uint32_t lines         = n_lines;
+    uint32_t slow          = n_slow;
+    uint64_t programmed_us = total_programmed_us;
+    uint64_t actual_us     = total_actual_us;
+    portEXIT_CRITICAL(&totals_spinlock);
+
+    uint8_t client = out->client();
+    grbl_msg_sendf(client, MsgLevel::Info, "%u lines, %u below %d%% of programmed feed", lines, slow, LINE_TIMING_SLOW_PERCENT);
+    grbl_msg_sendf(client,
+                   MsgLevel::Info,
+                   "Motion took %.3fs for %.3fs programmed, %d%%",
+                   actual_us / 1e6,
+                   programmed_us / 1e6,
+                   line_percent(programmed_us, actual_us));
+    for (uint8_t i = 0; i < worst_count; i++) {
+        const LineTime& l = worst[i];
+        grbl_msg_sendf(client,
+                       MsgLevel::Info,
+                       "Line %d took %.3fs for %.3fs programmed, %d%%",
+                       l.line_number,
+                       l.actual_us / 1e6,
+                       l.programmed_us / 1e6,
+                       line_percent(l.programmed_us, l.actual_us));
+    }
+}
+
+#endif
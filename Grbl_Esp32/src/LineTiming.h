@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+  LineTiming.h - time taken by each g-code line against its programmed feed rate
+  Part of Grbl_ESP32
+
+  With LINE_TIMING defined, the stepper ISR notes when the first
+  segment of each planner block starts, and the blocks of one g-code
+  line are timed together, from the start of their first block to the
+  start of the next line. The lines are told apart by a count of the
+  executed lines, as N numbers repeat or are left out; N is only the
+  label in the report. The last line of the motion ends when the
+  segment buffer runs empty with no blocks left. Time when the steppers are stopped, in a feed
+  hold or waiting for the next block, is not counted, nor are jogs,
+  homing and parking. The programmed time of a line is its length at
+  the programmed feed rate, or the rapid rate, without overrides. It
+  is counted once per planner block, also when a block is resumed
+  after a feed hold or parking.
+
+  A line is slow when it ran below LINE_TIMING_SLOW_PERCENT of its
+  programmed feed rate, as it does on short segments the planner
+  cannot get up to speed on.
+
+  $Trace/Lines         reports the totals and the lines that lost the most time
+  $Trace/Lines=ALL     lists the recent lines as CSV
+  $Trace/Lines=CLEAR   starts over
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if defined(LINE_TIMING) && !defined(USE_LINE_NUMBERS)
+#    error "LINE_TIMING needs USE_LINE_NUMBERS"
+#endif
+
+const int LINE_TIMING_LINES        = 256;  // Recent lines kept for $Trace/Lines=ALL
+const int LINE_TIMING_WORST        = 10;   // Lines that lost the most time
+const int LINE_TIMING_SLOW_PERCENT = 90;   // Of the programmed feed rate
+
+namespace WebUI {
+    class ESPResponseStream;
+}
+
+// A new step block starts, from the planner block with the given sequence number. Called by the stepper ISR.
+void line_timing_block(uint32_t line_index, int32_t line_number, uint32_t sequence, uint32_t programmed_us);
+
+// A segment starts. Called by the stepper ISR.
+void line_timing_segment();
+
+// The segment buffer ran empty, at the end of the motion if the planner is empty too. A line
+// is paused while it waits for more blocks, and done at the end. Called by the stepper ISR.
+void line_timing_stop(bool end);
+
+void line_timing_clear();
+
+// Report the totals and the worst lines, or list the recent lines as CSV
+void line_timing_report(WebUI::ESPResponseStream* out, bool all);
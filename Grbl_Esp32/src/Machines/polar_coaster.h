@@ -36,7 +36,7 @@
 #define RADIUS_AXIS 0
 #define POLAR_AXIS 1
 
-#define SEGMENT_LENGTH 0.5 // segment length in mm
+#define SEGMENT_LENGTH 0.5f // segment length in mm
 #define USE_KINEMATICS
 #define USE_FWD_KINEMATICS // report in cartesian
 #define USE_M30
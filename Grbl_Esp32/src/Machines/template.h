@@ -200,6 +200,13 @@
 // that implements custom tool change procedures.
 // #define USE_TOOL_CHANGE
 
+// USE_QUEUED_TOOL_CHANGE enables the user_tool_change_moves() function
+// that returns the moves of an automatic tool change, instead of
+// running them. They are planned with the program, so the approach to
+// the tool changer is blended with the motion before it.
+// Use it instead of USE_TOOL_CHANGE.
+// #define USE_QUEUED_TOOL_CHANGE
+
 // Any one of MACRO_BUTTON_0_PIN, MACRO_BUTTON_1_PIN, and MACRO_BUTTON_2_PIN
 // enables the user_defined_macro(number) function which
 // implements custom behavior at the press of a button
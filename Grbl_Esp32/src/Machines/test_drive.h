@@ -39,6 +39,11 @@
 
 
 #define N_AXIS 3
+
+// Uncomment to home, probe and open the door on a virtual machine, see SimulatedInputs.h
+// #define SIMULATED_INPUTS
+
+#ifndef SIMULATED_INPUTS
 // This cannot use homing because there are no switches
 #ifdef DEFAULT_HOMING_CYCLE_0
     #undef DEFAULT_HOMING_CYCLE_0
@@ -47,6 +52,7 @@
 #ifdef DEFAULT_HOMING_CYCLE_1
     #undef DEFAULT_HOMING_CYCLE_1
 #endif
+#endif
 
 #define SPINDLE_TYPE    SpindleType::NONE
 
@@ -24,6 +24,10 @@
 
 #include "Grbl.h"
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 // M_PI is not defined in standard C/C++ but some compilers
 // support it anyway.  The following suppresses Intellisense
 // problem reports.
@@ -75,6 +79,9 @@ void mc_line(float* target, plan_line_data_t* pl_data) {
     // indicates to Grbl what is a backlash compensation motion, so that Grbl executes the move but
     // doesn't update the machine position values. Since the position values used by the g-code
     // parser and planner are separate from the system machine positions, this is doable.
+#ifdef PLANNER_TASK
+    planner_task_line(target, pl_data);
+#else
     // If the buffer is full: good! That means we are well ahead of the robot.
     // Remain in this loop until there is room in the buffer.
     do {
@@ -91,8 +98,38 @@ void mc_line(float* target, plan_line_data_t* pl_data) {
     // Plan and queue motion into planner buffer
     // uint8_t plan_status; // Not used in normal operation.
     plan_buffer_line(target, pl_data);
+#endif
 }
 
+#if defined(NATIVE_ARCS) && !defined(USE_KINEMATICS)
+// mc_line only checks the target against the soft limits. An arc can go further out on its plane
+// axes, where it crosses them at each multiple of a quarter turn.
+static void mc_arc_soft_check(float*  target,
+                              float*  position,
+                              float*  center,
+                              float   angular_travel,
+                              uint8_t axis_0,
+                              uint8_t axis_1,
+                              uint8_t axis_linear) {
+    float point[MAX_N_AXIS];
+    memcpy(point, target, sizeof(point));
+    float radius  = hypot_f(position[axis_0] - center[0], position[axis_1] - center[1]);
+    float start   = atan2f(position[axis_1] - center[1], position[axis_0] - center[0]);
+    float quarter = float(M_PI) / 2;
+    float from    = MIN(start, start + angular_travel);
+    float to      = MAX(start, start + angular_travel);
+    for (float angle = ceilf(from / quarter) * quarter; angle < to; angle += quarter) {
+        point[axis_0]      = center[0] + radius * cosf(angle);
+        point[axis_1]      = center[1] + radius * sinf(angle);
+        point[axis_linear] = position[axis_linear] + (target[axis_linear] - position[axis_linear]) * (angle - start) / angular_travel;
+        limits_soft_check(point);
+        if (sys.abort) {
+            return;
+        }
+    }
+}
+#endif
+
 // Execute an arc in offset mode format. position == current xyz, target == target xyz,
 // offset == offset from current xyz, axis_X defines circle plane in tool space, axis_linear is
 // the direction of helical travel, radius == circle radius, isclockwise boolean. Used
@@ -126,21 +163,51 @@ void mc_arc(float*            target,
     }
 #endif
     // CCW angle between position and target from circle center. Only one atan2() trig computation required.
-    float angular_travel = atan2(r_axis0 * rt_axis1 - r_axis1 * rt_axis0, r_axis0 * rt_axis0 + r_axis1 * rt_axis1);
+    float angular_travel = atan2f(r_axis0 * rt_axis1 - r_axis1 * rt_axis0, r_axis0 * rt_axis0 + r_axis1 * rt_axis1);
     if (is_clockwise_arc) {  // Correct atan2 output per direction
         if (angular_travel >= -ARC_ANGULAR_TRAVEL_EPSILON) {
-            angular_travel -= 2 * M_PI;
+            angular_travel -= 2 * float(M_PI);
         }
     } else {
         if (angular_travel <= ARC_ANGULAR_TRAVEL_EPSILON) {
-            angular_travel += 2 * M_PI;
+            angular_travel += 2 * float(M_PI);
+        }
+    }
+#if defined(NATIVE_ARCS) && !defined(USE_KINEMATICS)
+    // Plan the arc as one block, when it only moves its plane and linear axes
+    bool in_plane = radius > 0;
+    for (uint8_t idx = 0; idx < number_axis->get(); idx++) {
+        if (idx != axis_0 && idx != axis_1 && idx != axis_linear && target[idx] != position[idx]) {
+            in_plane = false;
+        }
+    }
+    if (in_plane) {
+        float center[2] = { center_axis0, center_axis1 };
+        if (soft_limits->get()) {
+            mc_arc_soft_check(target, position, center, angular_travel, axis_0, axis_1, axis_linear);
+            if (sys.abort) {
+                return;
+            }
         }
+        pl_data->motion.arc         = 1;
+        pl_data->arc.center[0]      = center_axis0;
+        pl_data->arc.center[1]      = center_axis1;
+        pl_data->arc.radius[0]      = r_axis0;
+        pl_data->arc.radius[1]      = r_axis1;
+        pl_data->arc.angular_travel = angular_travel;
+        pl_data->arc.axis_0         = axis_0;
+        pl_data->arc.axis_1         = axis_1;
+        pl_data->arc.axis_linear    = axis_linear;
+        mc_line(target, pl_data);
+        pl_data->motion.arc = 0;
+        return;
     }
+#endif
     // NOTE: Segment end points are on the arc, which can lead to the arc diameter being smaller by up to
     // (2x) arc_tolerance. For 99% of users, this is just fine. If a different arc segment fit
     // is desired, i.e. least-squares, midpoint on arc, just change the mm_per_arc_segment calculation.
     // For the intended uses of Grbl, this value shouldn't exceed 2000 for the strictest of cases.
-    uint16_t segments = floor(fabs(0.5 * angular_travel * radius) / sqrt(arc_tolerance->get() * (2 * radius - arc_tolerance->get())));
+    uint16_t segments = floorf(fabsf(0.5f * angular_travel * radius) / sqrtf(arc_tolerance->get() * (2 * radius - arc_tolerance->get())));
     if (segments) {
         // Multiply inverse feed_rate to compensate for the fact that this movement is approximated
         // by a number of discrete segments. The inverse feed_rate should be correct for the sum of
@@ -177,9 +244,9 @@ void mc_arc(float*            target,
            This is important when there are successive arc motions.
         */
         // Computes: cos_T = 1 - theta_per_segment^2/2, sin_T = theta_per_segment - theta_per_segment^3/6) in ~52usec
-        float cos_T = 2.0 - theta_per_segment * theta_per_segment;
-        float sin_T = theta_per_segment * 0.16666667 * (cos_T + 4.0);
-        cos_T *= 0.5;
+        float cos_T = 2.0f - theta_per_segment * theta_per_segment;
+        float sin_T = theta_per_segment * 0.16666667f * (cos_T + 4.0f);
+        cos_T *= 0.5f;
         float    sin_Ti;
         float    cos_Ti;
         float    r_axisi;
@@ -195,8 +262,7 @@ void mc_arc(float*            target,
             } else {
                 // Arc correction to radius vector. Computed only every N_ARC_CORRECTION increments. ~375 usec
                 // Compute exact location by applying transformation matrix from initial radius vector(=-offset).
-                cos_Ti  = cos(i * theta_per_segment);
-                sin_Ti  = sin(i * theta_per_segment);
+                sincosf(i * theta_per_segment, &sin_Ti, &cos_Ti);
                 r_axis0 = -offset[axis_0] * cos_Ti + offset[axis_1] * sin_Ti;
                 r_axis1 = -offset[axis_0] * sin_Ti - offset[axis_1] * cos_Ti;
                 count   = 0;
@@ -223,6 +289,156 @@ void mc_arc(float*            target,
     mc_line_kins(target, pl_data, previous_position);
 }
 
+#ifdef SPINDLE_SYNC
+// Queue a line whose distance follows the spindle encoder, starting when the spindle is at
+// start_count. It runs on its own, from and to a stop, so its start refers to the spindle
+// position at the time it starts moving.
+static void mc_spindle_sync_line(float* target, plan_line_data_t* pl_data, float pitch, int64_t start_count) {
+    protocol_buffer_synchronize();
+    if (sys.abort) {
+        return;
+    }
+    pl_data->motion.spindleSync    = 1;
+    pl_data->motion.noFeedOverride = 1;
+    pl_data->sync_pitch            = pitch;
+    pl_data->sync_count            = start_count;
+    pl_data->feed_rate             = pitch * fabsf(spindle_encoder_rpm());  // Nominal rate for the planner only
+    mc_line(target, pl_data);  // Cartesian. A kinematics split would need a start for every piece.
+    protocol_buffer_synchronize();
+    pl_data->motion.spindleSync = 0;
+}
+
+// G33: Spindle synchronized line. The motion starts at the next whole revolution of the
+// spindle, so each pass of a threading cycle lands in the same thread.
+void mc_spindle_sync(float* target, plan_line_data_t* pl_data, float pitch) {
+    protocol_buffer_synchronize();
+    mc_spindle_sync_line(target, pl_data, pitch, spindle_encoder_next_rev(pl_data->spindle == SpindleState::Ccw));
+}
+
+// G84: Rigid tapping from r_level, where the tool is, down to z_bottom and back. The spindle
+// must turn M3. It is reversed at the bottom, and the retract follows it from the angle where
+// the tap reached the bottom, or from where the spindle is if the reversal has already taken
+// it back past that angle.
+static void mc_rigid_tap(float* xyz, plan_line_data_t* pl_data, float r_level, float z_bottom, float pitch) {
+    // Down
+    protocol_buffer_synchronize();
+    int64_t start_count  = spindle_encoder_next_rev(false);
+    int64_t bottom_count = start_count + lroundf((r_level - z_bottom) / pitch * spindle_encoder_cpr());
+    xyz[Z_AXIS]          = z_bottom;
+    pl_data->spindle     = SpindleState::Cw;
+    mc_spindle_sync_line(xyz, pl_data, pitch, start_count);
+
+    // Reverse and out. The spindle overshoots the bottom while it stops, and the encoder is read
+    // again once it turns back, so the retract does not have to chase the angle it has lost.
+    spindle->sync(SpindleState::Ccw, pl_data->spindle_speed);
+    int64_t reversed_count = spindle_encoder_count();
+    xyz[Z_AXIS]            = r_level;
+    pl_data->spindle       = SpindleState::Ccw;
+    mc_spindle_sync_line(xyz, pl_data, pitch, MIN(bottom_count, reversed_count));
+    spindle->sync(SpindleState::Cw, pl_data->spindle_speed);
+    pl_data->spindle = SpindleState::Cw;
+}
+#endif
+
+// G73/G81/G82/G83/G84: One hole of a canned cycle, at the XY of target. Rapid over the hole
+// and down to R, the cycle's motion down to the bottom and back to R, then rapid up to
+// retract_level. position is updated to where the cycle ends.
+void mc_canned_cycle(Motion cycle, float* target, plan_line_data_t* pl_data, float* position, canned_cycle_t* words, float retract_level) {
+    float xyz[MAX_N_AXIS];
+    memcpy(xyz, position, sizeof(xyz));
+
+    plan_line_data_t rapid   = *pl_data;
+    rapid.motion.rapidMotion = 1;
+    if (xyz[Z_AXIS] < words->r_level) {
+        xyz[Z_AXIS] = words->r_level;  // Up to R first if below it
+        mc_line(xyz, &rapid);
+    }
+    for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+        if (idx != Z_AXIS) {
+            xyz[idx] = target[idx];
+        }
+    }
+    mc_line(xyz, &rapid);
+    xyz[Z_AXIS] = words->r_level;
+    mc_line(xyz, &rapid);
+
+    switch (cycle) {
+        case Motion::Drill:
+        case Motion::DrillDwell:
+            xyz[Z_AXIS] = words->z_bottom;
+            mc_line(xyz, pl_data);
+            if (cycle == Motion::DrillDwell) {
+                mc_dwell(words->p);
+            }
+            xyz[Z_AXIS] = words->r_level;
+            mc_line(xyz, &rapid);
+            break;
+        case Motion::ChipBreakDrill:
+        case Motion::PeckDrill: {
+            // G83 clears the chips by going back up to R after every peck, G73 only breaks
+            // them with a short retract. Both return at rapid to just above the last depth.
+            float depth = words->r_level;
+            while (depth > words->z_bottom && !sys.abort) {
+                depth       = MAX(depth - words->q, words->z_bottom);
+                xyz[Z_AXIS] = depth;
+                mc_line(xyz, pl_data);
+                if (depth > words->z_bottom) {
+                    if (cycle == Motion::PeckDrill) {
+                        xyz[Z_AXIS] = words->r_level;
+                        mc_line(xyz, &rapid);
+                    }
+                    xyz[Z_AXIS] = MIN(depth + CANNED_CYCLE_CLEARANCE, words->r_level);
+                    mc_line(xyz, &rapid);
+                }
+            }
+            xyz[Z_AXIS] = words->r_level;
+            mc_line(xyz, &rapid);
+        } break;
+#ifdef SPINDLE_SYNC
+        case Motion::RigidTap:
+            mc_rigid_tap(xyz, pl_data, words->r_level, words->z_bottom, words->pitch);
+            break;
+#endif
+        default:
+            break;
+    }
+
+    if (retract_level > xyz[Z_AXIS]) {
+        xyz[Z_AXIS] = retract_level;  // G98
+        mc_line(xyz, &rapid);
+    }
+    memcpy(position, xyz, sizeof(xyz));
+}
+
+// M6: Unlike user_tool_change(), which runs the change itself and has to wait for the planner
+// to empty first, user_tool_change_moves() only returns the moves. They are planned like any other
+// motion, so the lookahead carries on through the change, and stops only where a move asks to dwell.
+void mc_tool_change(uint8_t new_tool, plan_line_data_t* pl_data, float* position) {
+#ifdef USE_QUEUED_TOOL_CHANGE
+    tool_change_move_t moves[TOOL_CHANGE_MAX_MOVES];
+    uint8_t            n_moves = user_tool_change_moves(new_tool, moves, TOOL_CHANGE_MAX_MOVES);
+    for (uint8_t i = 0; i < n_moves && !sys.abort; i++) {
+        plan_line_data_t move = *pl_data;
+        if (moves[i].feed_rate > 0.0f) {
+            move.feed_rate = moves[i].feed_rate;
+        } else {
+            move.motion.rapidMotion = 1;
+        }
+        mc_line(moves[i].target, &move);
+        memcpy(position, moves[i].target, sizeof(moves[i].target));
+        if (moves[i].outputs_on) {
+            sys_io_control(moves[i].outputs_on, true, true);
+        }
+        if (moves[i].outputs_off) {
+            sys_io_control(moves[i].outputs_off, false, true);
+        }
+        if (moves[i].dwell > 0.0f) {
+            mc_dwell(moves[i].dwell);
+        }
+    }
+#endif
+}
+
 // Execute dwell in seconds.
 void mc_dwell(float seconds) {
     if (sys.state == State::CheckMode) {
@@ -410,6 +626,9 @@ GCUpdatePos mc_probe_cycle(float* target, plan_line_data_t* pl_data, uint8_t par
     // Setup and queue probing motion. Auto cycle-start should not start the cycle.
     grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Found");
     mc_line_kins(target, pl_data, gc_state.position);
+#ifdef PLANNER_TASK
+    planner_task_synchronize();  // The probing motion must be in the planner for the cycle start
+#endif
     // Activate the probing state monitor in the stepper module.
     sys_probe_state = Probe::Active;
     // Perform probing cycle. Wait here until probe is triggered or motion completes.
@@ -461,10 +680,13 @@ void mc_parking_motion(float* parking_target, plan_line_data_t* pl_data) {
     }
     uint8_t plan_status = plan_buffer_line(parking_target, pl_data);
     if (plan_status) {
-        sys.step_control.executeSysMotion = true;
-        sys.step_control.endMotion        = false;  // Allow parking motion to execute, if feed hold is active.
-        st_parking_setup_buffer();                  // Setup step segment buffer for special parking motion case
-        st_prep_buffer();
+        {
+            PlannerLock lock;
+            sys.step_control.executeSysMotion = true;
+            sys.step_control.endMotion        = false;  // Allow parking motion to execute, if feed hold is active.
+            st_parking_setup_buffer();                  // Setup step segment buffer for special parking motion case
+            st_prep_buffer();
+        }
         st_wake_up();
         do {
             protocol_exec_rt_system();
@@ -32,6 +32,21 @@ const int PARKING_MOTION_LINE_NUMBER = 0;
 
 #define HOMING_CYCLE_ALL 0  // Must be zero.
 
+// One move of a queued M6 tool change sequence
+// Switching outputs or dwelling waits for the planner to empty, so leave them 0 to keep the lookahead.
+typedef struct {
+    float   target[MAX_N_AXIS];  // Machine position in mm
+    float   feed_rate;           // mm/min, 0 for a rapid move
+    uint8_t outputs_on;          // User digital outputs (M62 numbers, as a bit mask) to turn on after the move
+    uint8_t outputs_off;         // User digital outputs to turn off after the move
+    float   dwell;               // sec, after the outputs
+} tool_change_move_t;
+
+const int TOOL_CHANGE_MAX_MOVES = 16;
+
+// G83 stops its rapid back into the hole, and G73 retracts after each peck, by this distance in mm
+const float CANNED_CYCLE_CLEARANCE = 0.254;
+
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
 // (1 minute)/feed_rate time.
@@ -52,6 +67,19 @@ void mc_arc(float*            target,
             uint8_t           axis_linear,
             uint8_t           is_clockwise_arc);
 
+#ifdef SPINDLE_SYNC
+// G33 spindle synchronized line. pitch is the distance along the line per spindle revolution.
+void mc_spindle_sync(float* target, plan_line_data_t* pl_data, float pitch);
+#endif
+
+// One hole of a G73, G81, G82, G83 or G84 canned cycle at the XY of target. Ends at retract_level,
+// or at R if that is higher. position is updated to the end of the cycle.
+void mc_canned_cycle(Motion cycle, float* target, plan_line_data_t* pl_data, float* position, canned_cycle_t* words, float retract_level);
+
+// M6 as a planned sequence of moves from user_tool_change_moves(). The approach blends with the motion
+// before it. position is updated to the end of the sequence.
+void mc_tool_change(uint8_t new_tool, plan_line_data_t* pl_data, float* position);
+
 // Dwell for a specific number of seconds
 void mc_dwell(float seconds);
 
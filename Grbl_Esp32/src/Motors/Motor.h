@@ -83,6 +83,14 @@ namespace Motors {
         // states of the step pins are unknown.
         virtual void unstep() {}
 
+        // get_i2s_step_dir() reports the I2S expander bit masks of the
+        // step and direction pins and whether each one is inverted.
+        // motors_step() uses it to drive all such motors with a single
+        // port update per phase instead of calling step(), unstep() and
+        // set_direction() pin by pin.  It returns false unless both pins
+        // are I2S outputs.
+        virtual bool get_i2s_step_dir(uint32_t& step_bit, bool& invert_step, uint32_t& dir_bit, bool& invert_dir) { return false; }
+
         // test(), called from init(), checks to see if a motor is
         // responsive, returning true on failure.  Typical
         // implementations also display messages to show the result.
@@ -44,6 +44,59 @@
 #include "TrinamicDriver.h"
 
 Motors::Motor*      myMotor[MAX_AXES][MAX_GANGED];  // number of axes (normal and ganged)
+
+#ifdef USE_I2S_OUT
+// Expander bits of the motors whose step and direction pins are both I2S
+// outputs.  motors_step() and motors_unstep() drive these motors with one
+// i2s_out_write_bits() call per phase (direction, step, unstep) instead of
+// one atomic read-modify-write of the port data per pin.
+static bool     i2s_batched[MAX_AXES][MAX_GANGED];
+static uint32_t i2s_step_set[MAX_AXES][MAX_GANGED];    // bits to set to start a step pulse
+static uint32_t i2s_step_clear[MAX_AXES][MAX_GANGED];  // bits to clear to start a step pulse
+static uint32_t i2s_dir_bits[MAX_AXES];                // direction bits of both motors of an axis
+static uint32_t i2s_dir_invert[MAX_AXES];              // the subset of i2s_dir_bits that is inverted
+static uint32_t i2s_unstep_set;                        // bits to set to end the step pulses of all motors
+static uint32_t i2s_unstep_clear;                      // bits to clear to end the step pulses of all motors
+
+static void init_i2s_step_dir() {
+    auto     n_axis        = number_axis->get();
+    uint8_t  batched_count = 0;
+    uint32_t step_bit, dir_bit;
+    bool     invert_step, invert_dir;
+
+    i2s_unstep_set   = 0;
+    i2s_unstep_clear = 0;
+    for (uint8_t axis = X_AXIS; axis < MAX_AXES; axis++) {
+        i2s_dir_bits[axis]   = 0;
+        i2s_dir_invert[axis] = 0;
+        for (uint8_t gang_index = 0; gang_index < MAX_GANGED; gang_index++) {
+            i2s_batched[axis][gang_index]    = false;
+            i2s_step_set[axis][gang_index]   = 0;
+            i2s_step_clear[axis][gang_index] = 0;
+            if (axis >= n_axis || !myMotor[axis][gang_index]->get_i2s_step_dir(step_bit, invert_step, dir_bit, invert_dir)) {
+                continue;
+            }
+            i2s_batched[axis][gang_index] = true;
+            if (invert_step) {
+                i2s_step_clear[axis][gang_index] = step_bit;
+                i2s_unstep_set |= step_bit;
+            } else {
+                i2s_step_set[axis][gang_index] = step_bit;
+                i2s_unstep_clear |= step_bit;
+            }
+            i2s_dir_bits[axis] |= dir_bit;
+            if (invert_dir) {
+                i2s_dir_invert[axis] |= dir_bit;
+            }
+            batched_count++;
+        }
+    }
+    if (batched_count) {
+        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "I2S step/dir batched for %d motors", batched_count);
+    }
+}
+#endif
+
 void init_motors() {
     grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Init Motors");
 
@@ -277,19 +330,21 @@ void init_motors() {
             myMotor[axis][gang_index]->init();
         }
     }
+
+#ifdef USE_I2S_OUT
+    init_i2s_step_dir();
+#endif
 }
 
-void motors_set_disable(bool disable) {
+// Returns the previous disable state, so callers can tell when the drivers have just been enabled.
+bool motors_set_disable(bool disable) {
     static bool previous_state = true;
 
     //grbl_msg_sendf(CLIENT_SERIAL, MSG_LEVEL_INFO, "Motors disable %d", disable);
 
-    /*
-    if (previous_state == disable) {
-        return;
-    }
-    previous_state = disable;
-*/
+    // The pins are written every time, the state is only tracked.
+    bool was_disabled = previous_state;
+    previous_state    = disable;
 
     // now loop through all the motors to see if they can individually disable
     auto n_axis = number_axis->get();
@@ -304,6 +359,8 @@ void motors_set_disable(bool disable) {
         disable = !disable;  // Apply pin invert.
     }
     digitalWrite(STEPPERS_DISABLE_PIN, disable);
+
+    return was_disabled;
 }
 
 void motors_read_settings() {
@@ -335,6 +392,10 @@ uint8_t motors_set_homing_mode(uint8_t homing_mask, bool isHoming) {
 void motors_step(uint8_t step_mask, uint8_t dir_mask) {
     auto n_axis = number_axis->get();
     //grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "motors_set_direction_pins:0x%02X", onMask);
+#ifdef USE_I2S_OUT
+    uint32_t set_bits   = 0;
+    uint32_t clear_bits = 0;
+#endif
 
     // Set the direction pins, but optimize for the common
     // situation where the direction bits haven't changed.
@@ -344,27 +405,72 @@ void motors_step(uint8_t step_mask, uint8_t dir_mask) {
 
         for (int axis = X_AXIS; axis < n_axis; axis++) {
             bool thisDir = bitnum_istrue(dir_mask, axis);
+#ifdef USE_I2S_OUT
+            uint32_t high = i2s_dir_bits[axis] & (thisDir ? ~i2s_dir_invert[axis] : i2s_dir_invert[axis]);
+            set_bits |= high;
+            clear_bits |= i2s_dir_bits[axis] & ~high;
+            for (uint8_t gang_index = 0; gang_index < MAX_GANGED; gang_index++) {
+                if (!i2s_batched[axis][gang_index]) {
+                    myMotor[axis][gang_index]->set_direction(thisDir);
+                }
+            }
+#else
             myMotor[axis][0]->set_direction(thisDir);
             myMotor[axis][1]->set_direction(thisDir);
+#endif
         }
+#ifdef USE_I2S_OUT
+        // Direction phase: must land before the step phase below
+        if (set_bits | clear_bits) {
+            i2s_out_write_bits(set_bits, clear_bits);
+            set_bits   = 0;
+            clear_bits = 0;
+        }
+#endif
     }
     // Turn on step pulses for motors that are supposed to step now
     for (uint8_t axis = X_AXIS; axis < n_axis; axis++) {
         if (bitnum_istrue(step_mask, axis)) {
-            if ((ganged_mode == SquaringMode::Dual) || (ganged_mode == SquaringMode::A)) {
-                myMotor[axis][0]->step();
-            }
-            if ((ganged_mode == SquaringMode::Dual) || (ganged_mode == SquaringMode::B)) {
-                myMotor[axis][1]->step();
+            for (uint8_t gang_index = 0; gang_index < MAX_GANGED; gang_index++) {
+                if (gang_index == 0 && ganged_mode == SquaringMode::B) {
+                    continue;
+                }
+                if (gang_index == 1 && ganged_mode == SquaringMode::A) {
+                    continue;
+                }
+#ifdef USE_I2S_OUT
+                if (i2s_batched[axis][gang_index]) {
+                    set_bits |= i2s_step_set[axis][gang_index];
+                    clear_bits |= i2s_step_clear[axis][gang_index];
+                    continue;
+                }
+#endif
+                myMotor[axis][gang_index]->step();
             }
         }
     }
+#ifdef USE_I2S_OUT
+    if (set_bits | clear_bits) {
+        i2s_out_write_bits(set_bits, clear_bits);
+    }
+#endif
 }
 // Turn all stepper pins off
 void motors_unstep() {
     auto n_axis = number_axis->get();
     for (uint8_t axis = X_AXIS; axis < n_axis; axis++) {
-        myMotor[axis][0]->unstep();
-        myMotor[axis][1]->unstep();
+        for (uint8_t gang_index = 0; gang_index < MAX_GANGED; gang_index++) {
+#ifdef USE_I2S_OUT
+            if (i2s_batched[axis][gang_index]) {
+                continue;
+            }
+#endif
+            myMotor[axis][gang_index]->unstep();
+        }
+    }
+#ifdef USE_I2S_OUT
+    if (i2s_unstep_set | i2s_unstep_clear) {
+        i2s_out_write_bits(i2s_unstep_set, i2s_unstep_clear);
     }
+#endif
 }
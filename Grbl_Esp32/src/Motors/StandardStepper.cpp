@@ -120,6 +120,21 @@ namespace Motors {
 #endif  // USE_RMT_STEPS
     }
 
+    bool StandardStepper::get_i2s_step_dir(uint32_t& step_bit, bool& invert_step, uint32_t& dir_bit, bool& invert_dir) {
+#if defined(USE_I2S_OUT) && !defined(USE_RMT_STEPS)
+        if (_step_pin == UNDEFINED_PIN || _step_pin < I2S_OUT_PIN_BASE || _dir_pin == UNDEFINED_PIN || _dir_pin < I2S_OUT_PIN_BASE) {
+            return false;
+        }
+        step_bit    = bit(_step_pin - I2S_OUT_PIN_BASE);
+        invert_step = _invert_step_pin;
+        dir_bit     = bit(_dir_pin - I2S_OUT_PIN_BASE);
+        invert_dir  = _invert_dir_pin;
+        return true;
+#else
+        return false;
+#endif
+    }
+
     void StandardStepper::set_direction(bool dir) { digitalWrite(_dir_pin, dir ^ _invert_dir_pin); }
 
     void StandardStepper::set_disable(bool disable) { digitalWrite(_disable_pin, disable); }
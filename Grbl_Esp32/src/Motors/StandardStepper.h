@@ -15,6 +15,7 @@ namespace Motors {
         void set_direction(bool) override;
         void step() override;
         void unstep() override;
+        bool get_i2s_step_dir(uint32_t& step_bit, bool& invert_step, uint32_t& dir_bit, bool& invert_dir) override;
 
         void init_step_dir_pins();
 
@@ -25,6 +25,10 @@
 #include "Grbl.h"
 #include <cstring>
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 const int MAX_INT_DIGITS = 8;  // Maximum number of digits in int32 (and float)
 
 // Extracts a floating point value from a string. The following code is based loosely on
@@ -86,14 +90,14 @@ uint8_t read_float(const char* line, uint8_t* char_counter, float* float_ptr) {
     // expected range of E0 to E-4.
     if (fval != 0) {
         while (exp <= -2) {
-            fval *= 0.01;
+            fval *= 0.01f;
             exp += 2;
         }
         if (exp < 0) {
-            fval *= 0.1;
+            fval *= 0.1f;
         } else if (exp > 0) {
             do {
-                fval *= 10.0;
+                fval *= 10.0f;
             } while (--exp > 0);
         }
     }
@@ -113,7 +117,7 @@ void delay_ms(uint16_t ms) {
 
 // Non-blocking delay function used for general operation and suspend features.
 void delay_sec(float seconds, uint8_t mode) {
-    uint16_t i = ceil(1000 / DWELL_TIME_STEP * seconds);
+    uint16_t i = ceilf(1000 / DWELL_TIME_STEP * seconds);
     while (i-- > 0) {
         if (sys.abort) {
             return;
@@ -133,7 +137,7 @@ void delay_sec(float seconds, uint8_t mode) {
 
 // Simple hypotenuse computation function.
 float hypot_f(float x, float y) {
-    return sqrt(x * x + y * y);
+    return sqrtf(x * x + y * y);
 }
 
 float convert_delta_vector_to_unit_vector(float* vector) {
@@ -141,12 +145,12 @@ float convert_delta_vector_to_unit_vector(float* vector) {
     float   magnitude = 0.0;
     auto    n_axis    = number_axis->get();
     for (idx = 0; idx < n_axis; idx++) {
-        if (vector[idx] != 0.0) {
+        if (vector[idx] != 0.0f) {
             magnitude += vector[idx] * vector[idx];
         }
     }
-    magnitude           = sqrt(magnitude);
-    float inv_magnitude = 1.0 / magnitude;
+    magnitude           = sqrtf(magnitude);
+    float inv_magnitude = 1.0f / magnitude;
     for (idx = 0; idx < n_axis; idx++) {
         vector[idx] *= inv_magnitude;
     }
@@ -159,7 +163,7 @@ float limit_acceleration_by_axis_maximum(float* unit_vec) {
     auto    n_axis      = number_axis->get();
     for (idx = 0; idx < n_axis; idx++) {
         if (unit_vec[idx] != 0) {  // Avoid divide by zero.
-            limit_value = MIN(limit_value, fabs(axis_settings[idx]->acceleration->get() / unit_vec[idx]));
+            limit_value = MIN(limit_value, fabsf(axis_settings[idx]->acceleration->get() / unit_vec[idx]));
         }
     }
     // The acceleration setting is stored and displayed in units of mm/sec^2,
@@ -175,7 +179,7 @@ float limit_rate_by_axis_maximum(float* unit_vec) {
     auto    n_axis      = number_axis->get();
     for (idx = 0; idx < n_axis; idx++) {
         if (unit_vec[idx] != 0) {  // Avoid divide by zero.
-            limit_value = MIN(limit_value, fabs(axis_settings[idx]->max_rate->get() / unit_vec[idx]));
+            limit_value = MIN(limit_value, fabsf(axis_settings[idx]->max_rate->get() / unit_vec[idx]));
         }
     }
     return limit_value;
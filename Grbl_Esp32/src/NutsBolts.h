@@ -25,7 +25,7 @@
 // #define false 0
 // #define true 1
 
-const double SOME_LARGE_VALUE = 1.0E+38;
+const float SOME_LARGE_VALUE = 1.0E+38f;
 
 // Axis array index values. Must start with 0 and be continuous.
 // Note: You set the number of axes used by changing MAX_N_AXIS.
@@ -54,8 +54,8 @@ static inline int toMotor2(int axis) {
 }
 
 // Conversions
-const double MM_PER_INCH = (25.40);
-const double INCH_PER_MM = (0.0393701);
+const float MM_PER_INCH = (25.40f);
+const float INCH_PER_MM = (0.0393701f);
 
 const int DELAY_MODE_DWELL       = 0;
 const int DELAY_MODE_SYS_SUSPEND = 1;
@@ -0,0 +1,135 @@
+/*
+  OutputScheduler.cpp - timed output events for the stepper drivers
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+// The step timer uses TIMER_0 of the same group
+const timer_group_t OUTPUT_TIMER_GROUP = TIMER_GROUP_0;
+const timer_idx_t   OUTPUT_TIMER_INDEX = TIMER_1;
+
+// Events due sooner than this are run by spinning. It must also cover the time
+// between reading the counter and arming the alarm, or the alarm could be missed.
+const uint64_t OUTPUT_SCHED_MIN_LEAD_TICKS = 2 * ticksPerMicrosecond;
+
+typedef struct {
+    uint64_t            time;
+    output_event_func_t func;
+    uint8_t             arg0;
+    uint8_t             arg1;
+} output_event_t;
+
+static output_event_t output_queue[OUTPUT_SCHED_QUEUE_SIZE];  // Sorted by time, earliest first
+static uint8_t        output_queue_count = 0;
+
+static portMUX_TYPE output_sched_spinlock = portMUX_INITIALIZER_UNLOCKED;
+#define OUTPUT_SCHED_ENTER_CRITICAL()                                                                                                      \
+    do {                                                                                                                                   \
+        if (xPortInIsrContext()) {                                                                                                         \
+            portENTER_CRITICAL_ISR(&output_sched_spinlock);                                                                                \
+        } else {                                                                                                                           \
+            portENTER_CRITICAL(&output_sched_spinlock);                                                                                    \
+        }                                                                                                                                  \
+    } while (0)
+#define OUTPUT_SCHED_EXIT_CRITICAL()                                                                                                       \
+    do {                                                                                                                                   \
+        if (xPortInIsrContext()) {                                                                                                         \
+            portEXIT_CRITICAL_ISR(&output_sched_spinlock);                                                                                 \
+        } else {                                                                                                                           \
+            portEXIT_CRITICAL(&output_sched_spinlock);                                                                                     \
+        }                                                                                                                                  \
+    } while (0)
+
+uint64_t IRAM_ATTR output_sched_now() {
+    uint64_t now;
+    timer_get_counter_value(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX, &now);
+    return now;
+}
+
+// Run the events that are due and arm the alarm for the next one.
+// Must be called with the lock held.
+static void IRAM_ATTR output_sched_service() {
+    while (output_queue_count > 0) {
+        output_event_t event = output_queue[0];
+        uint64_t       now   = output_sched_now();
+        if (event.time > now + OUTPUT_SCHED_MIN_LEAD_TICKS) {
+            timer_set_alarm_value(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX, event.time);
+            TIMERG0.hw_timer[OUTPUT_TIMER_INDEX].config.alarm_en = TIMER_ALARM_EN;
+            return;
+        }
+        while (output_sched_now() < event.time) {
+            NOP();  // spin the last bit
+        }
+        output_queue_count--;
+        memmove(&output_queue[0], &output_queue[1], output_queue_count * sizeof(output_event_t));
+        event.func(event.arg0, event.arg1);
+    }
+}
+
+static void IRAM_ATTR onOutputSchedTimer(void* para) {
+    TIMERG0.int_clr_timers.t1 = 1;
+    OUTPUT_SCHED_ENTER_CRITICAL();
+    output_sched_service();
+    OUTPUT_SCHED_EXIT_CRITICAL();
+}
+
+bool IRAM_ATTR output_sched_at(uint64_t time, output_event_func_t func, uint8_t arg0, uint8_t arg1) {
+    OUTPUT_SCHED_ENTER_CRITICAL();
+    if (output_queue_count == OUTPUT_SCHED_QUEUE_SIZE) {
+        OUTPUT_SCHED_EXIT_CRITICAL();
+        return false;
+    }
+    // Insertion sort from the back. Events for the same time keep their order.
+    int i = output_queue_count;
+    while (i > 0 && output_queue[i - 1].time > time) {
+        output_queue[i] = output_queue[i - 1];
+        i--;
+    }
+    output_queue[i].time = time;
+    output_queue[i].func = func;
+    output_queue[i].arg0 = arg0;
+    output_queue[i].arg1 = arg1;
+    output_queue_count++;
+    if (i == 0) {
+        // New earliest event. Run it now if it is (nearly) due, else move the alarm.
+        output_sched_service();
+    }
+    OUTPUT_SCHED_EXIT_CRITICAL();
+    return true;
+}
+
+void IRAM_ATTR output_sched_reset() {
+    OUTPUT_SCHED_ENTER_CRITICAL();
+    TIMERG0.hw_timer[OUTPUT_TIMER_INDEX].config.alarm_en = TIMER_ALARM_DIS;
+    output_queue_count                                   = 0;
+    OUTPUT_SCHED_EXIT_CRITICAL();
+}
+
+void output_sched_init() {
+    timer_config_t config;
+    config.divider     = fTimers / fStepperTimer;
+    config.counter_dir = TIMER_COUNT_UP;
+    config.counter_en  = TIMER_PAUSE;
+    config.alarm_en    = TIMER_ALARM_DIS;
+    config.intr_type   = TIMER_INTR_LEVEL;
+    config.auto_reload = false;  // Free running time base
+    timer_init(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX, &config);
+    timer_set_counter_value(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX, 0x00000000ULL);
+    timer_enable_intr(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX);
+    timer_isr_register(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX, onOutputSchedTimer, NULL, 0, NULL);
+    timer_start(OUTPUT_TIMER_GROUP, OUTPUT_TIMER_INDEX);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+  OutputScheduler.h - timed output events for the stepper drivers
+  Part of Grbl_ESP32
+
+  Events such as "step pins on", "step pins off" or "start the step
+  timer" are queued at absolute times of a free running hardware timer
+  that counts at fStepperTimer (50 nsec per tick).  The timer interrupt
+  runs each event when it is due, so the stepper ISR no longer has to
+  spin for the step pulse length, the direction setup time or the
+  driver enable time.  Events that are due in less than a couple of
+  microseconds are run by spinning instead, because the interrupt
+  would take about as long.
+
+  Only the stepper ISR uses it, for GPIO and static I2S stepping. RMT
+  stepping times its pulse and STEP_PULSE_DELAY in the RMT peripheral,
+  and the I2S stream times them with its samples.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+
+typedef void (*output_event_func_t)(uint8_t arg0, uint8_t arg1);
+
+const int OUTPUT_SCHED_QUEUE_SIZE = 8;  // Pending events. The stepper ISR needs at most 2 per tick, plus 2 per burst pulse.
+
+// Start the free running time base. Call once before any other function.
+void output_sched_init();
+
+// The current time in ticks of fStepperTimer
+uint64_t output_sched_now();
+
+// Run func(arg0, arg1) at the given time. Due or nearly due events are run before returning.
+// Returns false, without queuing, if the queue is full.
+bool output_sched_at(uint64_t time, output_event_func_t func, uint8_t arg0 = 0, uint8_t arg1 = 0);
+
+// Drop all pending events
+void output_sched_reset();
@@ -26,6 +26,10 @@
 #include "Grbl.h"
 #include <stdlib.h>  // PSoc Required for labs
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
 static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
 static uint8_t      block_buffer_tail;                // Index of the block to process now
 static uint8_t      block_buffer_head;                // Index of the next block to be pushed
@@ -196,6 +200,8 @@ static void planner_recalculate() {
 }
 
 void plan_reset() {
+    PlannerLock lock;
+
     memset(&pl, 0, sizeof(planner_t));  // Clear planner struct
     plan_reset_buffer();
 }
@@ -249,10 +255,10 @@ uint8_t plan_check_full_buffer() {
 float plan_compute_profile_nominal_speed(plan_block_t* block) {
     float nominal_speed = block->programmed_rate;
     if (block->motion.rapidMotion) {
-        nominal_speed *= (0.01 * sys.r_override);
+        nominal_speed *= (0.01f * sys.r_override);
     } else {
         if (!(block->motion.noFeedOverride)) {
-            nominal_speed *= (0.01 * sys.f_override);
+            nominal_speed *= (0.01f * sys.f_override) * (0.01f * sys.f_adaptive);
         }
         if (nominal_speed > block->rapid_rate) {
             nominal_speed = block->rapid_rate;
@@ -281,6 +287,8 @@ static void plan_compute_profile_parameters(plan_block_t* block, float nominal_s
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters() {
+    PlannerLock lock;
+
     uint8_t       block_index = block_buffer_tail;
     plan_block_t* block;
     float         nominal_speed;
@@ -295,7 +303,69 @@ void plan_update_velocity_profile_parameters() {
     pl.previous_nominal_speed = prev_nominal_speed;  // Update prev nominal speed for next incoming block.
 }
 
+#ifdef NATIVE_ARCS
+// Sets the length, limits and junction directions of an arc block. unit_vec is set to the direction
+// the arc starts in, and exit_unit_vec to the direction it ends in.
+static void plan_arc_parameters(plan_block_t* block, int32_t* position_steps, float* unit_vec, float* exit_unit_vec) {
+    plan_arc_t& arc       = block->arc;
+    uint8_t     axis_0    = arc.axis_0;
+    uint8_t     axis_1    = arc.axis_1;
+    uint8_t     axis_lin  = arc.axis_linear;
+    float       radius    = hypot_f(arc.radius[0], arc.radius[1]);
+    float       plane_mm  = fabsf(arc.angular_travel) * radius;
+    float       linear_mm = block->steps[axis_lin] / axis_settings[axis_lin]->steps_per_mm->get();
+
+    arc.millimeters    = hypot_f(plane_mm, linear_mm);
+    arc.start_steps[0] = position_steps[axis_0];
+    arc.start_steps[1] = position_steps[axis_1];
+    arc.start_steps[2] = position_steps[axis_lin];
+    block->millimeters = arc.millimeters;
+
+    // Around the circle, either plane axis can take all of the plane motion
+    float plane_share  = plane_mm / arc.millimeters;
+    float linear_share = linear_mm / arc.millimeters;
+    clear_vector_float(unit_vec);
+    unit_vec[axis_0]    = plane_share;
+    unit_vec[axis_1]    = plane_share;
+    unit_vec[axis_lin]  = linear_share;
+    block->acceleration = limit_acceleration_by_axis_maximum(unit_vec);
+    block->rapid_rate   = limit_rate_by_axis_maximum(unit_vec);
+
+    // Slow enough that a step segment needs no more than ARC_SEGMENT_CHORDS chords within arc_tolerance
+    float chord_mm    = sqrtf(8 * radius * arc_tolerance->get()) / plane_share;
+    block->rapid_rate = MIN(block->rapid_rate, ARC_SEGMENT_CHORDS * chord_mm / DT_SEGMENT);
+
+    // At the highest speed of the arc, the centripetal acceleration takes up to ARC_CENTRIPETAL_SHARE of the
+    // acceleration of the plane axes. The speed changes along the arc get the rest, so the sum stays within it.
+    float plane_acceleration = MIN(axis_settings[axis_0]->acceleration->get(), axis_settings[axis_1]->acceleration->get()) * SEC_PER_MIN_SQ;
+    float plane_rate         = MIN(block->rapid_rate * plane_share, sqrtf(ARC_CENTRIPETAL_SHARE * plane_acceleration * radius));
+    float centripetal        = plane_rate * plane_rate / radius;
+    float tangential         = sqrtf(plane_acceleration * plane_acceleration - centripetal * centripetal);
+    block->rapid_rate        = plane_rate / plane_share;
+    block->acceleration      = MIN(block->acceleration, tangential / plane_share);
+
+    // Tangents at the start and the end, turning the way the arc goes
+    if (bit_istrue(block->direction_bits, bit(axis_lin))) {
+        linear_share = -linear_share;
+    }
+    float turn = (arc.angular_travel > 0 ? plane_share : -plane_share) / radius;
+    float sin_travel, cos_travel;
+    sincosf(arc.angular_travel, &sin_travel, &cos_travel);
+    float end_0 = arc.radius[0] * cos_travel - arc.radius[1] * sin_travel;
+    float end_1 = arc.radius[0] * sin_travel + arc.radius[1] * cos_travel;
+    clear_vector_float(exit_unit_vec);
+    unit_vec[axis_0]        = -arc.radius[1] * turn;
+    unit_vec[axis_1]        = arc.radius[0] * turn;
+    unit_vec[axis_lin]      = linear_share;
+    exit_unit_vec[axis_0]   = -end_1 * turn;
+    exit_unit_vec[axis_1]   = end_0 * turn;
+    exit_unit_vec[axis_lin] = linear_share;
+}
+#endif
+
 uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
+    PlannerLock lock;
+
     // Prepare and initialize new block. Copy relevant pl_data for block execution.
     plan_block_t* block = &block_buffer[block_buffer_head];
     memset(block, 0, sizeof(plan_block_t));  // Zero all block values.
@@ -303,9 +373,28 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
     block->coolant       = pl_data->coolant;
     block->spindle       = pl_data->spindle;
     block->spindle_speed = pl_data->spindle_speed;
+#ifdef SPINDLE_SYNC
+    block->sync_pitch = pl_data->sync_pitch;
+    block->sync_count = pl_data->sync_count;
+#endif
+#ifdef CONSTANT_SURFACE_SPEED
+    block->surface_speed     = pl_data->surface_speed;
+    block->max_spindle_speed = pl_data->max_spindle_speed;
+    block->spindle_axis_x    = pl_data->spindle_axis_x;
+#endif
+#ifdef NATIVE_ARCS
+    if (block->motion.arc) {
+        block->arc = pl_data->arc;
+    }
+#endif
 
 #ifdef USE_LINE_NUMBERS
     block->line_number = pl_data->line_number;
+#endif
+#ifdef LINE_TIMING
+    static uint32_t sequence = 0;
+    block->line_index        = pl_data->line_index;
+    block->sequence          = ++sequence;
 #endif
     // Compute and store initial move distance data.
     int32_t target_steps[MAX_N_AXIS], position_steps[MAX_N_AXIS];
@@ -322,28 +411,44 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         // Calculate target position in absolute steps, number of steps for each axis, and determine max step events.
         // Also, compute individual axes distance for move and prep unit vector calculations.
         // NOTE: Computes true distance from converted step values.
-        target_steps[idx]       = lround(target[idx] * axis_settings[idx]->steps_per_mm->get());
+        target_steps[idx]       = lroundf(target[idx] * axis_settings[idx]->steps_per_mm->get());
         block->steps[idx]       = labs(target_steps[idx] - position_steps[idx]);
         block->step_event_count = MAX(block->step_event_count, block->steps[idx]);
         delta_mm                = (target_steps[idx] - position_steps[idx]) / axis_settings[idx]->steps_per_mm->get();
         unit_vec[idx]           = delta_mm;  // Store unit vector numerator
         // Set direction bits. Bit enabled always means direction is negative.
-        if (delta_mm < 0.0) {
+        if (delta_mm < 0.0f) {
             block->direction_bits |= bit(idx);
         }
     }
-    // Bail if this is a zero-length block. Highly unlikely to occur.
-    if (block->step_event_count == 0) {
+    // Bail if this is a zero-length block. Highly unlikely to occur. A full circle ends where it starts.
+    if (block->step_event_count == 0 && !block->motion.arc) {
         return PLAN_EMPTY_BLOCK;
     }
 
-    // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
-    // down such that no individual axes maximum values are exceeded with respect to the line direction.
-    // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
-    // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
-    block->millimeters  = convert_delta_vector_to_unit_vector(unit_vec);
-    block->acceleration = limit_acceleration_by_axis_maximum(unit_vec);
-    block->rapid_rate   = limit_rate_by_axis_maximum(unit_vec);
+#ifdef NATIVE_ARCS
+    float exit_unit_vec[MAX_N_AXIS];  // Direction an arc ends in, for the next junction
+    if (block->motion.arc) {
+        plan_arc_parameters(block, position_steps, unit_vec, exit_unit_vec);
+    } else
+#endif
+    {
+        // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
+        // down such that no individual axes maximum values are exceeded with respect to the line direction.
+        // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
+        // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
+        block->millimeters  = convert_delta_vector_to_unit_vector(unit_vec);
+        block->acceleration = limit_acceleration_by_axis_maximum(unit_vec);
+        block->rapid_rate   = limit_rate_by_axis_maximum(unit_vec);
+    }
+#ifdef CONSTANT_SURFACE_SPEED
+    // G96: X along the block, for the spindle speed of each step segment
+    if (block->surface_speed > 0.0f) {
+        float x_steps_per_mm = axis_settings[X_AXIS]->steps_per_mm->get();
+        block->css_x         = target_steps[X_AXIS] / x_steps_per_mm;
+        block->css_x_per_mm  = (target_steps[X_AXIS] - position_steps[X_AXIS]) / x_steps_per_mm / block->millimeters;
+    }
+#endif
     // Store programmed rate.
     if (block->motion.rapidMotion) {
         block->programmed_rate = block->rapid_rate;
@@ -388,20 +493,20 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
             junction_unit_vec[idx] = unit_vec[idx] - pl.previous_unit_vec[idx];
         }
         // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
-        if (junction_cos_theta > 0.999999) {
+        if (junction_cos_theta > 0.999999f) {
             //  For a 0 degree acute junction, just set minimum junction speed.
             block->max_junction_speed_sqr = MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED;
         } else {
-            if (junction_cos_theta < -0.999999) {
+            if (junction_cos_theta < -0.999999f) {
                 // Junction is a straight line or 180 degrees. Junction speed is infinite.
                 block->max_junction_speed_sqr = SOME_LARGE_VALUE;
             } else {
                 convert_delta_vector_to_unit_vector(junction_unit_vec);
                 float junction_acceleration = limit_acceleration_by_axis_maximum(junction_unit_vec);
-                float sin_theta_d2          = sqrt(0.5 * (1.0 - junction_cos_theta));  // Trig half angle identity. Always positive.
+                float sin_theta_d2          = sqrtf(0.5f * (1.0f - junction_cos_theta));  // Trig half angle identity. Always positive.
                 block->max_junction_speed_sqr =
                     MAX(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
-                        (junction_acceleration * junction_deviation->get() * sin_theta_d2) / (1.0 - sin_theta_d2));
+                        (junction_acceleration * junction_deviation->get() * sin_theta_d2) / (1.0f - sin_theta_d2));
             }
         }
     }
@@ -411,7 +516,11 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         plan_compute_profile_parameters(block, nominal_speed, pl.previous_nominal_speed);
         pl.previous_nominal_speed = nominal_speed;
         // Update previous path unit_vector and planner position.
+#ifdef NATIVE_ARCS
+        memcpy(pl.previous_unit_vec, block->motion.arc ? exit_unit_vec : unit_vec, sizeof(unit_vec));
+#else
         memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec));  // pl.previous_unit_vec[] = unit_vec[]
+#endif
         memcpy(pl.position, target_steps, sizeof(target_steps));   // pl.position[] = target_steps[]
         // New block is all set. Update buffer head and next buffer head indices.
         block_buffer_head = next_buffer_head;
@@ -424,6 +533,8 @@ uint8_t plan_buffer_line(float* target, plan_line_data_t* pl_data) {
 
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position() {
+    PlannerLock lock;
+
     // TODO: For motor configurations not in the same coordinate frame as the machine position,
     // this function needs to be updated to accomodate the difference.
     uint8_t idx;
@@ -455,6 +566,8 @@ uint8_t plan_get_block_buffer_count() {
 // Re-initialize buffer plan with a partially completed block, assumed to exist at the buffer tail.
 // Called after a steppers have come to a complete stop for a feed hold and the cycle is stopped.
 void plan_cycle_reinitialize() {
+    PlannerLock lock;
+
     // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
     st_update_plan_block_parameters();
     block_buffer_planned = block_buffer_tail;
@@ -43,14 +43,31 @@ struct PlMotion {
     uint8_t systemMotion : 1;    // Single motion. Circumvents planner state. Used by home/park.
     uint8_t noFeedOverride : 1;  // Motion does not honor feed override.
     uint8_t inverseTime : 1;     // Interprets feed rate value as inverse time when set.
+    uint8_t spindleSync : 1;     // Distance follows the spindle encoder (G33/G84), not the velocity profile.
+    uint8_t arc : 1;             // Circular or helical motion, see plan_arc_t. NATIVE_ARCS only.
 };
 
+#ifdef NATIVE_ARCS
+// An arc planned as one block. The step segment generator traces it along the circle, a few chords
+// per segment, instead of running a Bresenham line over the whole block.
+typedef struct {
+    float   center[2];       // Circle center on axis_0 and axis_1 (mm)
+    float   radius[2];       // From the center to the start of the arc (mm)
+    float   angular_travel;  // Counterclockwise positive (radians)
+    float   millimeters;     // Length of the whole path, including the helix (mm)
+    int32_t start_steps[3];  // Position of axis_0, axis_1 and axis_linear at the start (steps)
+    uint8_t axis_0;
+    uint8_t axis_1;
+    uint8_t axis_linear;
+} plan_arc_t;
+#endif
+
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
 // are as specified in the source g-code.
 typedef struct {
     // Fields used by the bresenham algorithm for tracing the line
     // NOTE: Used by stepper algorithm to execute the block correctly. Do not alter these values.
-    uint32_t steps[MAX_N_AXIS];     // Step count along each axis
+    uint32_t steps[N_AXIS];     // Step count along each axis. number_axis is always N_AXIS.
     uint32_t step_event_count;  // The maximum step axis count and number of steps required to complete this block.
     uint8_t  direction_bits;    // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
 
@@ -61,6 +78,10 @@ typedef struct {
 #ifdef USE_LINE_NUMBERS
     int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
 #endif
+#ifdef LINE_TIMING
+    uint32_t line_index;  // Copied from pl_line_data
+    uint32_t sequence;    // Counts the planned blocks, so a block is timed once however often it is prepped
+#endif
 
     // Fields used by the motion planner to manage acceleration. Some of these values may be updated
     // by the stepper module during execution of special motion cases for replanning purposes.
@@ -78,7 +99,25 @@ typedef struct {
 
     // Stored spindle speed data used by spindle overrides and resuming methods.
     float spindle_speed;  // Block spindle speed. Copied from pl_line_data.
-    //#endif
+
+#ifdef SPINDLE_SYNC
+    // Spindle synchronized motion. Copied from pl_line_data.
+    float   sync_pitch;  // Distance along the block per spindle revolution (mm)
+    int64_t sync_count;  // Spindle position at the start of the block (encoder counts)
+#endif
+
+#ifdef CONSTANT_SURFACE_SPEED
+    // Constant surface speed (G96). Copied from pl_line_data, 0 surface_speed without G96.
+    float surface_speed;      // Cutting speed at the tool (mm/min)
+    float max_spindle_speed;  // Spindle speed limit (RPM)
+    float spindle_axis_x;     // Machine X of the spindle axis (mm)
+    float css_x;              // Machine X at the end of the block (mm). Set by the planner.
+    float css_x_per_mm;       // Change of X per mm of the block
+#endif
+
+#ifdef NATIVE_ARCS
+    plan_arc_t arc;  // Copied from pl_line_data, when motion.arc is set
+#endif
 } plan_block_t;
 
 // Planner data prototype. Must be used when passing new motions to the planner.
@@ -88,9 +127,24 @@ typedef struct {
     PlMotion     motion;         // Bitflag variable to indicate motion conditions. See defines above.
     SpindleState spindle;        // Spindle enable state
     CoolantState coolant;        // Coolant state
+#ifdef SPINDLE_SYNC
+    float   sync_pitch;  // Spindle synchronized motion only: mm per spindle revolution
+    int64_t sync_count;  // Spindle synchronized motion only: spindle encoder count to start at
+#endif
+#ifdef CONSTANT_SURFACE_SPEED
+    float surface_speed;      // G96 only: cutting speed at the tool (mm/min)
+    float max_spindle_speed;  // G96 only: spindle speed limit (RPM)
+    float spindle_axis_x;     // G96 only: machine X of the spindle axis (mm)
+#endif
+#ifdef NATIVE_ARCS
+    plan_arc_t arc;  // Arc motion only. The planner fills in millimeters and start_steps.
+#endif
 #ifdef USE_LINE_NUMBERS
     int32_t line_number;  // Desired line number to report when executing.
 #endif
+#ifdef LINE_TIMING
+    uint32_t line_index;  // Counts the executed g-code lines. 0 for jogs, homing and parking, which are not timed.
+#endif
 } plan_line_data_t;
 
 // Initialize and reset the motion plan subsystem
@@ -0,0 +1,122 @@
+/*
+  PlannerTask.cpp - plans the parsed lines on the other core
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#ifdef PLANNER_TASK
+
+struct PlannerLine {
+    float            target[MAX_N_AXIS];
+    plan_line_data_t pl_data;
+};
+
+SemaphoreHandle_t    planner_mutex = NULL;
+static QueueHandle_t line_queue    = NULL;
+static volatile bool planning      = false;  // A line is off the queue and not yet in the planner
+
+// Homing and parking plan the block at the head of the planner buffer, and without the task
+// no line is planned in a suspend, as the parser waits in protocol_exec_rt_suspend().
+static bool planner_task_can_plan() {
+    return !sys.abort && sys.suspend.value == 0 && !sys.step_control.executeSysMotion && sys.state != State::Homing;
+}
+
+static void plannerTask(void* pvParameters) {
+    PlannerLine line;
+    while (true) {
+        bool planned = false;
+        if (planner_task_can_plan() && uxQueueMessagesWaiting(line_queue)) {
+            if (plan_check_full_buffer()) {
+                protocol_auto_cycle_start();  // Auto-cycle start when buffer is full, as mc_line() does.
+            } else {
+                PlannerLock lock;
+                planning = true;
+                if (planner_task_can_plan() && xQueueReceive(line_queue, &line, 0) == pdTRUE) {
+                    plan_buffer_line(line.target, &line.pl_data);
+                    planned = true;
+                }
+                planning = false;
+            }
+        }
+
+        // Reload step segment buffer
+        switch (sys.state) {
+            case State::Cycle:
+            case State::Hold:
+            case State::SafetyDoor:
+            case State::Homing:
+            case State::Sleep:
+            case State::Jog:
+                st_prep_buffer();
+                break;
+            default:
+                break;
+        }
+
+        if (!planned) {
+            vTaskDelay(1);
+            static UBaseType_t uxHighWaterMark = 0;
+            reportTaskStackSize(uxHighWaterMark);
+        }
+    }
+}
+
+void planner_task_init() {
+    if (line_queue == NULL) {
+        planner_mutex = xSemaphoreCreateRecursiveMutex();
+        line_queue    = xQueueCreate(PLANNER_TASK_QUEUE_SIZE, sizeof(PlannerLine));
+        xTaskCreatePinnedToCore(plannerTask,            // task
+                                "plannerTask",          // name for task
+                                4096,                   // size of task stack
+                                NULL,                   // parameters
+                                PLANNER_TASK_PRIORITY,  // priority
+                                NULL,
+                                0  // core, the protocol loop runs on core 1
+        );
+    }
+}
+
+void planner_task_line(float* target, plan_line_data_t* pl_data) {
+    PlannerLine line;
+    memcpy(line.target, target, sizeof(line.target));
+    line.pl_data = *pl_data;
+    // If the queue is full: good! That means we are well ahead of the planner.
+    do {
+        protocol_execute_realtime();  // Check for any run-time commands
+        if (sys.abort) {
+            return;  // Bail, if system abort.
+        }
+    } while (xQueueSend(line_queue, &line, 1) != pdTRUE);
+}
+
+void planner_task_synchronize() {
+    // Check the queue first. The task sets planning before it takes a line off the queue, so a line
+    // that is not in the planner yet is always seen on the queue or as planning.
+    while (uxQueueMessagesWaiting(line_queue) || planning) {
+        protocol_execute_realtime();  // Check and execute run-time commands
+        if (sys.abort) {
+            return;  // Check for system abort
+        }
+    }
+}
+
+void planner_task_reset() {
+    PlannerLock lock;
+    xQueueReset(line_queue);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+  PlannerTask.h - plans the parsed lines on the other core
+  Part of Grbl_ESP32
+
+  With PLANNER_TASK defined, mc_line() does not plan its line. It puts
+  the line on a queue, and a task on core 0 takes it off the queue,
+  plans it with plan_buffer_line() and keeps the step segment buffer
+  full, while the protocol loop on core 1 parses the next lines,
+  generates the arcs and runs the kinematics.
+
+  The queue holds a line with everything plan_buffer_line() needs, so
+  the modal state of each line goes with it. mc_line() waits when the
+  queue is full, as it waits for room in the planner buffer without
+  the task, and protocol_buffer_synchronize() waits for the queue to
+  be planned before it waits for the motion to end. The task plans no
+  lines during a feed hold, a safety door, parking or homing, as the
+  parser is held in those without it.
+
+  The planner and the step segment buffer are changed from both cores,
+  so the functions that change them hold PlannerLock while they run.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef PLANNER_TASK
+
+const int PLANNER_TASK_QUEUE_SIZE = 16;  // Lines parsed ahead of the planner
+
+// Above the lwIP TCP/IP task (18) on core 0, so network traffic does not hold up the step segment
+// buffer, and below the WiFi driver task (23). The task sleeps a tick whenever it has no line to plan.
+const int PLANNER_TASK_PRIORITY = 19;
+
+extern SemaphoreHandle_t planner_mutex;
+
+// Holds the planner and the step segment buffer for the scope it is declared in
+class PlannerLock {
+public:
+    PlannerLock() {
+        if (planner_mutex) {
+            xSemaphoreTakeRecursive(planner_mutex, portMAX_DELAY);
+        }
+    }
+    ~PlannerLock() {
+        if (planner_mutex) {
+            xSemaphoreGiveRecursive(planner_mutex);
+        }
+    }
+};
+
+void planner_task_init();
+
+// Queue a line for the planner task. Waits for room in the queue, running the realtime commands.
+void planner_task_line(float* target, plan_line_data_t* pl_data);
+
+// Wait for the planner task to plan every queued line, running the realtime commands.
+void planner_task_synchronize();
+
+// Drop the queued lines, on a reset or a jog cancel
+void planner_task_reset();
+
+#else
+
+class PlannerLock {
+public:
+    PlannerLock() {}
+};
+
+#endif
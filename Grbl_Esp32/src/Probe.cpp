@@ -50,6 +50,11 @@ void set_probe_direction(bool is_away) {
 
 // Returns the probe pin state. Triggered = true. Called by gcode parser and probe state monitor.
 bool probe_get_state() {
+#ifdef SIMULATED_INPUTS
+    if (sim_inputs_probe()) {
+        return true;
+    }
+#endif
     return digitalRead(PROBE_PIN) ^ probe_invert->get();
 }
 
@@ -59,6 +59,7 @@ void settings_restore(uint8_t restore_flag) {
         for (auto idx = CoordIndex::Begin; idx < CoordIndex::End; ++idx) {
             coords[idx]->setDefault();
         }
+        offset_table->setDefault();
     }
 }
 
@@ -213,6 +214,146 @@ Error disable_alarm_lock(const char* value, WebUI::AuthenticationLevel auth_leve
     }  // Otherwise, no effect.
     return Error::Ok;
 }
+#ifdef AXIS_ENCODER_SIMULATED
+// $Encoder/Slip=X0.5 moves the simulated X encoder by 0.5mm, to try out the following error check
+Error encoder_slip(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    if (!value) {
+        return Error::InvalidStatement;
+    }
+    const char* axis_letters = "XYZABC";
+    const char* axis_letter  = strchr(axis_letters, toupper(value[0]));
+    uint8_t     char_counter = 1;
+    float       mm;
+    if (value[0] == '\0' || !axis_letter || !read_float(value, &char_counter, &mm)) {
+        return Error::BadNumberFormat;
+    }
+    axis_encoder_slip(axis_letter - axis_letters, mm);
+    return Error::Ok;
+}
+#endif
+#ifdef SIMULATED_INPUTS
+// $Sim/Position=X-10Y-20 moves the virtual machine, $Sim/Position reports where it is
+Error sim_move(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    const char* axis_letters = "XYZABC";
+    auto        n_axis       = number_axis->get();
+    if (!value) {
+        char position[MAX_N_AXIS * 14 + 1] = "";
+        char temp[14];
+        for (uint8_t axis = X_AXIS; axis < n_axis; axis++) {
+            sprintf(temp, " %c%.3f", axis_letters[axis], sim_inputs_position(axis));
+            strcat(position, temp);
+        }
+        grbl_msg_sendf(out->client(), MsgLevel::Info, "Sim position:%s", position);
+        return Error::Ok;
+    }
+    uint8_t char_counter = 0;
+    while (value[char_counter]) {
+        const char* axis_letter = strchr(axis_letters, toupper(value[char_counter]));
+        float       mm;
+        char_counter++;
+        if (!axis_letter || axis_letter - axis_letters >= n_axis || !read_float(value, &char_counter, &mm)) {
+            return Error::BadNumberFormat;
+        }
+        sim_inputs_set_position(axis_letter - axis_letters, mm);
+    }
+    return Error::Ok;
+}
+// $Sim/Probe=Z-30 puts the probe surface at Z-30, $Sim/Probe removes it
+Error sim_probe(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    if (!value) {
+        sim_inputs_set_probe(-1, 0.0);
+        return Error::Ok;
+    }
+    const char* axis_letters = "XYZABC";
+    const char* axis_letter  = strchr(axis_letters, toupper(value[0]));
+    uint8_t     char_counter = 1;
+    float       mm;
+    if (value[0] == '\0' || !axis_letter || !read_float(value, &char_counter, &mm)) {
+        return Error::BadNumberFormat;
+    }
+    sim_inputs_set_probe(axis_letter - axis_letters, mm);
+    return Error::Ok;
+}
+// $Sim/Event=Hold@1.5 holds 1.5 seconds from now, see SimulatedInputs.h
+Error sim_event(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    return sim_inputs_schedule(value);
+}
+#endif
+#ifdef FLOAT_MATH_CHECK
+// $Bench/Math times the float math of the motion core against the double math it replaced, in CPU cycles per call
+static volatile float bench_in = 0.7f;
+static volatile float bench_out;
+
+static void bench_none() {}
+static void bench_sqrt() {
+    bench_out = sqrt(double(bench_in));
+}
+static void bench_sqrtf() {
+    bench_out = sqrtf(bench_in);
+}
+static void bench_atan2() {
+    bench_out = atan2(double(bench_in), 0.3);
+}
+static void bench_atan2f() {
+    bench_out = atan2f(bench_in, 0.3f);
+}
+static void bench_sincos() {
+    bench_out = sin(double(bench_in)) + cos(double(bench_in));
+}
+static void bench_sincosf() {
+    float s, c;
+    sincosf(bench_in, &s, &c);
+    bench_out = s + c;
+}
+static void bench_divide() {
+    bench_out = 0.5 / double(bench_in);
+}
+static void bench_dividef() {
+    bench_out = 0.5f / bench_in;
+}
+static uint32_t bench_loop(void (*f)()) {
+    const int n     = 1000;
+    uint32_t  start = ESP.getCycleCount();
+    for (int i = 0; i < n; i++) {
+        f();
+    }
+    return (ESP.getCycleCount() - start) / n;
+}
+static uint32_t bench_cycles(void (*f)()) {
+    return bench_loop(f) - bench_loop(bench_none);
+}
+Error bench_math(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    struct {
+        const char* name;
+        void (*as_double)();
+        void (*as_float)();
+    } kernels[] = {
+        { "sqrt", bench_sqrt, bench_sqrtf },
+        { "atan2", bench_atan2, bench_atan2f },
+        { "sin+cos", bench_sincos, bench_sincosf },
+        { "divide", bench_divide, bench_dividef },
+    };
+    for (auto& k : kernels) {
+        grbl_msg_sendf(
+            out->client(), MsgLevel::Info, "%s double %u float %u cycles", k.name, bench_cycles(k.as_double), bench_cycles(k.as_float));
+    }
+    return Error::Ok;
+}
+#endif
+#ifdef LINE_TIMING
+// $Trace/Lines reports the lines that fell short of their feed rate, =ALL lists the recent ones, =CLEAR starts over
+Error report_line_timing(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    if (value && strcasecmp(value, "CLEAR") == 0) {
+        line_timing_clear();
+        return Error::Ok;
+    }
+    if (value && strcasecmp(value, "ALL") != 0) {
+        return Error::InvalidValue;
+    }
+    line_timing_report(out, value != NULL);
+    return Error::Ok;
+}
+#endif
 Error report_ngc(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
     report_ngc_parameters(out->client());
     return Error::Ok;
@@ -438,6 +579,20 @@ void make_grbl_commands() {
     new GrblCommand("I", "Build/Info", get_report_build_info, idleOrAlarm);
     new GrblCommand("N", "GCode/StartupLines", report_startup_lines, idleOrAlarm);
     new GrblCommand("RST", "Settings/Restore", restore_settings, idleOrAlarm, WA);
+#ifdef AXIS_ENCODER_SIMULATED
+    new GrblCommand("ES", "Encoder/Slip", encoder_slip, anyState);
+#endif
+#ifdef LINE_TIMING
+    new GrblCommand("TL", "Trace/Lines", report_line_timing, anyState);
+#endif
+#ifdef FLOAT_MATH_CHECK
+    new GrblCommand("BM", "Bench/Math", bench_math, idleOrAlarm);
+#endif
+#ifdef SIMULATED_INPUTS
+    new GrblCommand("SIP", "Sim/Position", sim_move, idleOrAlarm);
+    new GrblCommand("SIPR", "Sim/Probe", sim_probe, anyState);
+    new GrblCommand("SIE", "Sim/Event", sim_event, anyState);
+#endif
 };
 
 // normalize_key puts a key string into canonical form -
@@ -0,0 +1,174 @@
+/*
+  ProfileTrace.cpp - record of the velocity profiles computed by st_prep_buffer()
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#ifdef PROFILE_TRACE
+
+// Block flags
+const uint8_t PROFILE_REPLANNED = bit(0);  // The planner changed a block that had started
+const uint8_t PROFILE_HOLD      = bit(1);  // Forced deceleration of a feed hold
+const uint8_t PROFILE_SYSTEM    = bit(2);  // Homing or parking motion
+
+struct ProfileBlock {
+    float    time;             // Motion time at the start of the block (s)
+    float    millimeters;      // Left to run
+    float    entry_speed;      // mm/min, and so on
+    float    nominal_speed;    // With the overrides
+    float    exit_speed;       // Where the profile ends
+    float    max_entry_speed;  // Junction limit, or less for the nominal speeds around it
+    float    junction_speed;   // Junction limit alone
+    int32_t  line_number;
+    uint16_t id;
+    uint8_t  depth;  // Blocks in the planner
+    uint8_t  flags;
+};
+
+struct ProfileSegment {
+    float    time;   // Motion time at the end of the segment (s)
+    float    speed;  // mm/min at the end of the segment
+    uint16_t block;  // id of the block
+    uint16_t n_step;
+};
+
+static ProfileBlock   blocks[PROFILE_TRACE_BLOCKS];
+static ProfileSegment segments[PROFILE_TRACE_SEGMENTS];
+static uint16_t       block_head    = 0;  // Next to write
+static uint16_t       block_count   = 0;
+static uint16_t       segment_head  = 0;
+static uint16_t       segment_count = 0;
+static uint16_t       block_id      = 0;
+static float          profile_time  = 0.0;
+
+void profile_trace_block(plan_block_t* block, bool replanned, float entry_speed, float exit_speed) {
+    if (!replanned) {
+        block_id++;
+    }
+    ProfileBlock& b   = blocks[block_head];
+    b.time            = profile_time;
+    b.millimeters     = block->millimeters;
+    b.entry_speed     = entry_speed;
+    b.nominal_speed   = plan_compute_profile_nominal_speed(block);
+    b.exit_speed      = exit_speed;
+    b.max_entry_speed = sqrtf(block->max_entry_speed_sqr);
+    b.junction_speed  = sqrtf(block->max_junction_speed_sqr);
+#ifdef USE_LINE_NUMBERS
+    b.line_number = block->line_number;
+#else
+    b.line_number = 0;
+#endif
+    b.id    = block_id;
+    b.depth = plan_get_block_buffer_count();
+    b.flags = 0;
+    if (replanned) {
+        b.flags |= PROFILE_REPLANNED;
+    }
+    if (sys.step_control.executeHold) {
+        b.flags |= PROFILE_HOLD;
+    }
+    if (sys.step_control.executeSysMotion) {
+        b.flags |= PROFILE_SYSTEM;
+    }
+    block_head = (block_head + 1) % PROFILE_TRACE_BLOCKS;
+    if (block_count < PROFILE_TRACE_BLOCKS) {
+        block_count++;
+    }
+}
+
+void profile_trace_segment(float dt, float speed, uint16_t n_step) {
+    profile_time += dt * 60.0f;
+    ProfileSegment& s = segments[segment_head];
+    s.time            = profile_time;
+    s.speed           = speed;
+    s.block           = block_id;
+    s.n_step          = n_step;
+    segment_head      = (segment_head + 1) % PROFILE_TRACE_SEGMENTS;
+    if (segment_count < PROFILE_TRACE_SEGMENTS) {
+        segment_count++;
+    }
+}
+
+void profile_trace_clear() {
+    block_count   = 0;
+    segment_count = 0;
+    profile_time  = 0.0;
+}
+
+void profile_trace_report(WebUI::ESPResponseStream* out, bool json) {
+    char line[160];
+    // Taken once. Blocks prepared while the trace is listed may overwrite the oldest ones.
+    uint16_t n_blocks   = block_count;
+    uint16_t first      = (block_head + PROFILE_TRACE_BLOCKS - n_blocks) % PROFILE_TRACE_BLOCKS;
+    uint16_t n_segments = segment_count;
+    uint16_t first_seg  = (segment_head + PROFILE_TRACE_SEGMENTS - n_segments) % PROFILE_TRACE_SEGMENTS;
+
+    if (json) {
+        out->print("{\"blocks\":[");
+    } else {
+        out->println("#block,id,line,time,mm,entry,nominal,exit,max_entry,junction,depth,flags");
+    }
+    for (uint16_t i = 0; i < n_blocks; i++) {
+        const ProfileBlock& b = blocks[(first + i) % PROFILE_TRACE_BLOCKS];
+        snprintf(line,
+                 sizeof(line),
+                 json ? "%s[%u,%d,%.4f,%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%u,%u]" : "%sblock,%u,%d,%.4f,%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%u,%u",
+                 json && i ? "," : "",
+                 b.id,
+                 b.line_number,
+                 b.time,
+                 b.millimeters,
+                 b.entry_speed,
+                 b.nominal_speed,
+                 b.exit_speed,
+                 b.max_entry_speed,
+                 b.junction_speed,
+                 b.depth,
+                 b.flags);
+        if (json) {
+            out->print(line);
+        } else {
+            out->println(line);
+        }
+    }
+    if (json) {
+        out->print("],\"segments\":[");
+    } else {
+        out->println("#segment,block,time,speed,steps");
+    }
+    for (uint16_t i = 0; i < n_segments; i++) {
+        const ProfileSegment& s = segments[(first_seg + i) % PROFILE_TRACE_SEGMENTS];
+        snprintf(line,
+                 sizeof(line),
+                 json ? "%s[%u,%.4f,%.1f,%u]" : "%ssegment,%u,%.4f,%.1f,%u",
+                 json && i ? "," : "",
+                 s.block,
+                 s.time,
+                 s.speed,
+                 s.n_step);
+        if (json) {
+            out->print(line);
+        } else {
+            out->println(line);
+        }
+    }
+    if (json) {
+        out->println("]}");
+    }
+}
+
+#endif
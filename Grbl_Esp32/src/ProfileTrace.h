@@ -0,0 +1,55 @@
+#pragma once
+
+/*
+  ProfileTrace.h - record of the velocity profiles computed by st_prep_buffer()
+  Part of Grbl_ESP32
+
+  With PROFILE_TRACE defined, st_prep_buffer() records every planner
+  block it starts or replans, with the entry, nominal and exit speeds
+  it runs at and the junction and entry limits the planner gave it,
+  and the time and speed of every step segment it prepares. Time is
+  planned motion time in seconds, so the trace is the same however
+  fast the job is streamed, and it does not count idle time.
+
+  $Trace/Profile         lists the trace as CSV
+  $Trace/Profile=JSON    lists it as JSON, for data/profile.html
+  $Trace/Profile=CLEAR   starts a new trace
+
+  A block that enters slower than its junction limit was held back by
+  the blocks after it, usually because the planner buffer ran out.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILE_TRACE_BLOCKS
+#    define PROFILE_TRACE_BLOCKS 128  // The newest blocks are kept
+#endif
+#ifndef PROFILE_TRACE_SEGMENTS
+#    define PROFILE_TRACE_SEGMENTS 1024  // The newest segments are kept
+#endif
+
+namespace WebUI {
+    class ESPResponseStream;
+}
+
+// Record a block that st_prep_buffer() starts, or replans when replanned is true. Speeds in mm/min.
+void profile_trace_block(plan_block_t* block, bool replanned, float entry_speed, float exit_speed);
+
+// Record a prepared segment. dt is in minutes, speed in mm/min at the end of the segment.
+void profile_trace_segment(float dt, float speed, uint16_t n_step);
+
+void profile_trace_clear();
+
+// List the trace as CSV, or as JSON
+void profile_trace_report(WebUI::ESPResponseStream* out, bool json);
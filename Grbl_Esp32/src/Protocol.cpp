@@ -205,6 +205,9 @@ void protocol_main_loop() {
 // Block until all buffered steps are executed or in a cycle state. Works with feed hold
 // during a synchronize call, if it should happen. Also, waits for clean cycle end.
 void protocol_buffer_synchronize() {
+#ifdef PLANNER_TASK
+    planner_task_synchronize();  // Plan the lines still queued for the planner task
+#endif
     // If system is queued, ensure cycle resumes if the auto start flag is present.
     protocol_auto_cycle_start();
     do {
@@ -256,8 +259,11 @@ void protocol_exec_rt_system() {
         // loop until system reset/abort.
         sys.state = State::Alarm;  // Set system alarm state
         report_alarm_message(alarm);
-        // Halt everything upon a critical event flag. Currently hard and soft limits flag this.
-        if ((alarm == ExecAlarm::HardLimit) || (alarm == ExecAlarm::SoftLimit)) {
+        if (alarm == ExecAlarm::FollowingError) {
+            axis_encoder_report_trace();
+        }
+        // Halt everything upon a critical event flag. Currently hard and soft limits and following errors flag this.
+        if ((alarm == ExecAlarm::HardLimit) || (alarm == ExecAlarm::SoftLimit) || (alarm == ExecAlarm::FollowingError)) {
             report_feedback_message(Message::CriticalEvent);
             sys_rt_exec_state.bit.reset = false;  // Disable any existing reset
             do {
@@ -291,6 +297,7 @@ void protocol_exec_rt_system() {
                 // If in CYCLE or JOG states, immediately initiate a motion HOLD.
                 if (sys.state == State::Cycle || sys.state == State::Jog) {
                     if (!(sys.suspend.bit.motionCancel || sys.suspend.bit.jogCancel)) {  // Block, if already holding.
+                        PlannerLock lock;                   // The block is recomputed with the hold flag set
                         st_update_plan_block_parameters();  // Notify stepper module to recompute for hold deceleration.
                         sys.step_control             = {};
                         sys.step_control.executeHold = true;  // Initiate suspend state with active flag.
@@ -339,6 +346,7 @@ void protocol_exec_rt_system() {
 #ifdef PARKING_ENABLE
                                 // Set hold and reset appropriate control flags to restart parking sequence.
                                 if (sys.step_control.executeSysMotion) {
+                                    PlannerLock lock;                   // The block is recomputed with the hold flag set
                                     st_update_plan_block_parameters();  // Notify stepper module to recompute for hold deceleration.
                                     sys.step_control                  = {};
                                     sys.step_control.executeHold      = true;
@@ -395,6 +403,7 @@ void protocol_exec_rt_system() {
                         sys.spindle_stop_ovr.bit.restoreCycle = true;  // Set to restore in suspend routine and cycle start after.
                     } else {
                         // Start cycle only if queued motions exist in planner buffer and the motion is not canceled.
+                        PlannerLock lock;
                         sys.step_control = {};  // Restore step control to normal operation
                         if (plan_get_current_block() && !sys.suspend.bit.motionCancel) {
                             sys.suspend.value = 0;  // Break suspend state.
@@ -420,6 +429,7 @@ void protocol_exec_rt_system() {
                 !(sys.suspend.bit.jogCancel)) {
                 // Hold complete. Set to indicate ready to resume.  Remain in HOLD or DOOR states until user
                 // has issued a resume command or reset.
+                PlannerLock lock;
                 plan_cycle_reinitialize();
                 if (sys.step_control.executeHold) {
                     sys.suspend.bit.holdComplete = true;
@@ -430,7 +440,11 @@ void protocol_exec_rt_system() {
                 // Motion complete. Includes CYCLE/JOG/HOMING states and jog cancel/motion cancel/soft limit events.
                 // NOTE: Motion and jog cancel both immediately return to idle after the hold completes.
                 if (sys.suspend.bit.jogCancel) {  // For jog cancel, flush buffers and sync positions.
+                    PlannerLock lock;
                     sys.step_control = {};
+#ifdef PLANNER_TASK
+                    planner_task_reset();
+#endif
                     plan_reset();
                     st_reset();
                     gc_sync_position();
@@ -445,10 +459,12 @@ void protocol_exec_rt_system() {
                     sys.state         = State::Idle;
                 }
             }
+            shaper_report_late();
             cycle_stop = false;
         }
     }
     // Execute overrides.
+    adaptive_feed_update();
     if ((sys_rt_f_override != sys.f_override) || (sys_rt_r_override != sys.r_override)) {
         sys.f_override         = sys_rt_f_override;
         sys.r_override         = sys_rt_r_override;
@@ -508,7 +524,8 @@ void protocol_exec_rt_system() {
         sys_rt_exec_debug = false;
     }
 #endif
-    // Reload step segment buffer
+#ifndef PLANNER_TASK
+    // Reload step segment buffer. The planner task does it with PLANNER_TASK.
     switch (sys.state) {
         case State::Cycle:
         case State::Hold:
@@ -521,6 +538,7 @@ void protocol_exec_rt_system() {
         default:
             break;
     }
+#endif
 }
 
 // Handles Grbl system suspend procedures, such as feed hold, safety door, and parking motion.
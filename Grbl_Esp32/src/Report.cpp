@@ -350,13 +350,46 @@ void report_ngc_parameters(uint8_t client) {
     ;
     ngc_rpt += "]\r\n";
     grbl_send(client, ngc_rpt.c_str());
+    report_offset_table(client);
     report_probe_parameters(client);
 }
 
+// Prints the entries of the tool and fixture tables that have been set
+void report_offset_table(uint8_t client) {
+    String table_rpt = "";
+    float  mm_factor = report_inches->get() ? INCH_PER_MM : 1.0;
+    for (uint8_t tool = 1; tool <= N_TOOL_TABLE; tool++) {
+        float length = offset_table->toolLength(tool);
+        if (length != 0.0) {
+            table_rpt += "[T";
+            table_rpt += String(tool);
+            table_rpt += ":";
+            table_rpt += String(length * mm_factor, 3);
+            table_rpt += "]\r\n";
+        }
+    }
+    for (uint8_t fixture = 1; fixture <= N_FIXTURE_TABLE; fixture++) {
+        const float* offsets = offset_table->getFixture(fixture);
+        for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+            if (offsets[idx] != 0.0) {
+                table_rpt += "[G54.1 P";
+                table_rpt += String(fixture);
+                table_rpt += ":";
+                table_rpt += report_util_axis_values(offsets);
+                table_rpt += "]\r\n";
+                break;
+            }
+        }
+    }
+    if (table_rpt.length()) {
+        grbl_send(client, table_rpt.c_str());
+    }
+}
+
 // Print current gcode parser mode state
 void report_gcode_modes(uint8_t client) {
     char        temp[20];
-    char        modes_rpt[75];
+    char        modes_rpt[112];
     const char* mode = "";
     strcpy(modes_rpt, "[GC:");
 
@@ -376,6 +409,24 @@ void report_gcode_modes(uint8_t client) {
         case Motion::CcwArc:
             mode = "G3";
             break;
+        case Motion::SpindleSync:
+            mode = "G33";
+            break;
+        case Motion::ChipBreakDrill:
+            mode = "G73";
+            break;
+        case Motion::Drill:
+            mode = "G81";
+            break;
+        case Motion::DrillDwell:
+            mode = "G82";
+            break;
+        case Motion::PeckDrill:
+            mode = "G83";
+            break;
+        case Motion::RigidTap:
+            mode = "G84";
+            break;
         case Motion::ProbeToward:
             mode = "G38.1";
             break;
@@ -391,7 +442,11 @@ void report_gcode_modes(uint8_t client) {
     }
     strcat(modes_rpt, mode);
 
-    sprintf(temp, " G%d", gc_state.modal.coord_select + 54);
+    if (gc_state.modal.fixture) {
+        sprintf(temp, " G54.1 P%d", gc_state.modal.fixture);
+    } else {
+        sprintf(temp, " G%d", gc_state.modal.coord_select + 54);
+    }
     strcat(modes_rpt, temp);
 
     switch (gc_state.modal.plane_select) {
@@ -445,6 +500,29 @@ void report_gcode_modes(uint8_t client) {
     }
     strcat(modes_rpt, mode);
 
+    switch (gc_state.modal.retract) {
+        case RetractMode::InitialLevel:
+            mode = " G98";
+            break;
+        case RetractMode::RLevel:
+            mode = " G99";
+            break;
+    }
+    strcat(modes_rpt, mode);
+
+    // Only reported while active, as senders expect G97. S is the spindle speed it started at.
+    if (gc_state.modal.spindle_speed_mode == SpindleSpeedMode::SurfaceSpeed) {
+        strcat(modes_rpt, " G96");
+    }
+
+    // Only reported while active, as senders do not know G50/G69
+    if (gc_state.scaled) {
+        strcat(modes_rpt, " G51");
+    }
+    if (gc_state.rotated) {
+        strcat(modes_rpt, " G68");
+    }
+
     //report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
         case ProgramFlow::Running:
@@ -569,6 +647,7 @@ void report_build_info(const char* line, uint8_t client) {
     // These will likely have a comma delimiter to separate them.
     grbl_send(client, "]\r\n");
     report_machine_type(client);
+    st_report_buffer_sizes(client);
 #if defined(ENABLE_WIFI)
     grbl_send(client, (char*)WebUI::wifi_config.info());
 #endif
@@ -593,7 +672,7 @@ void report_realtime_status(uint8_t client) {
     int32_t current_position[MAX_N_AXIS];  // Copy current state of the system position variable
     memcpy(current_position, sys_position, sizeof(sys_position));
     float print_position[MAX_N_AXIS];
-    char  status[200];
+    char  status[256];
     char  temp[MAX_N_AXIS * 20];
     system_convert_array_steps_to_mpos(print_position, current_position);
     // Report current machine state and sub-states
@@ -645,13 +724,10 @@ void report_realtime_status(uint8_t client) {
         auto n_axis = number_axis->get();
         for (idx = 0; idx < n_axis; idx++) {
             // Apply work coordinate offsets and tool length offset to current position.
-            wco[idx] = gc_state.coord_system[idx] + gc_state.coord_offset[idx];
-            if (idx == TOOL_LENGTH_OFFSET_AXIS) {
-                wco[idx] += gc_state.tool_length_offset;
-            }
-            if (bit_isfalse(status_mask->get(), RtStatus::Position)) {
-                print_position[idx] -= wco[idx];
-            }
+            wco[idx] = gc_state.work_offset[idx];
+        }
+        if (bit_isfalse(status_mask->get(), RtStatus::Position)) {
+            gc_machine_to_work(print_position, gc_state.work_offset, print_position);  // Also undoes G51 and G68
         }
     }
     // Report machine position
@@ -808,6 +884,10 @@ void report_realtime_status(uint8_t client) {
 
         sprintf(temp, "|Ov:%d,%d,%d", sys.f_override, sys.r_override, sys.spindle_speed_ovr);
         strcat(status, temp);
+        if (spindle_adaptive_load->get() > 0.0) {
+            sprintf(temp, "|Ad:%d,%d", sys.f_adaptive, int(spindle->get_load()));
+            strcat(status, temp);
+        }
         SpindleState sp_state      = spindle->get_state();
         CoolantState coolant_state = coolant_get_state();
         if (sp_state != SpindleState::Disable || coolant_state.Mist || coolant_state.Flood) {
@@ -835,6 +915,15 @@ void report_realtime_status(uint8_t client) {
         }
     }
 #endif
+    if (axis_encoder_axes()) {
+        float following_error[MAX_N_AXIS];  // 0 for the axes that are not checked
+        for (uint8_t idx = 0; idx < MAX_N_AXIS; idx++) {
+            following_error[idx] = axis_encoder_error(idx);
+        }
+        strcat(status, "|FE:");
+        report_util_axis_values(following_error, temp);
+        strcat(status, temp);
+    }
 #ifdef ENABLE_SD_CARD
     if (get_sd_state(false) == SDCARD_BUSY_PRINTING) {
         sprintf(temp, "|SD:%4.2f,", sd_report_perc_complete());
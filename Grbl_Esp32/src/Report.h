@@ -101,6 +101,9 @@ void report_probe_parameters(uint8_t client);
 // Prints Grbl NGC parameters (coordinate offsets, probe)
 void report_ngc_parameters(uint8_t client);
 
+// Prints the tool and fixture tables
+void report_offset_table(uint8_t client);
+
 // Prints current g-code parser mode state
 void report_gcode_modes(uint8_t client);
 
@@ -723,3 +723,33 @@ void Coordinates::set(float value[MAX_N_AXIS]) {
 #endif
     nvs_set_blob(Setting::_handle, _name, _currentValue, sizeof(_currentValue));
 }
+
+OffsetTable* offset_table;
+
+bool OffsetTable::load() {
+    size_t len = sizeof(_table);
+    // A table of another size, e.g. from a build with a different MAX_N_AXIS, is not used
+    return nvs_get_blob(Setting::_handle, _name, &_table, &len) == ESP_OK && len == sizeof(_table);
+}
+
+void OffsetTable::setDefault() {
+    memset(&_table, 0, sizeof(_table));
+    store();
+}
+
+void OffsetTable::store() {
+#ifdef FORCE_BUFFER_SYNC_DURING_NVS_WRITE
+    protocol_buffer_synchronize();
+#endif
+    nvs_set_blob(Setting::_handle, _name, &_table, sizeof(_table));
+}
+
+void OffsetTable::setToolLength(uint8_t tool, float length) {
+    _table.tool_length[tool] = length;
+    store();
+}
+
+void OffsetTable::setFixture(uint8_t fixture, float* value) {
+    memcpy(_table.fixture[fixture], value, sizeof(_table.fixture[fixture]));
+    store();
+}
@@ -250,6 +250,39 @@ public:
 
 extern Coordinates* coords[CoordIndex::End];
 
+const int N_TOOL_TABLE    = 100;  // T1-T100, used by G43 H and G10 L1/L10
+const int N_FIXTURE_TABLE = 50;   // G54.1 P1-P50, also G10 L2/L20 P7-P56
+
+// The tool lengths and fixture offsets are kept in one NVS entry, so they are read
+// in one go at boot. Any change writes the whole table back.
+class OffsetTable {
+private:
+    struct {
+        float tool_length[N_TOOL_TABLE + 1];             // Entry 0 is no tool and stays 0
+        float fixture[N_FIXTURE_TABLE + 1][MAX_N_AXIS];  // Entry 0 is not used
+    } _table;
+    const char* _name;
+
+    void store();
+
+public:
+    OffsetTable(const char* name) : _name(name) {}
+
+    const char* getName() { return _name; }
+    bool        load();
+    void        setDefault();
+
+    float toolLength(uint8_t tool) { return _table.tool_length[tool]; }
+    void  setToolLength(uint8_t tool, float length);
+    // Copy the offsets of a fixture to an array
+    void getFixture(uint8_t fixture, float* value) { memcpy(value, _table.fixture[fixture], sizeof(_table.fixture[fixture])); }
+    // Return a pointer to the offsets of a fixture
+    const float* getFixture(uint8_t fixture) { return _table.fixture[fixture]; }
+    void         setFixture(uint8_t fixture, float* value);
+};
+
+extern OffsetTable* offset_table;
+
 class FloatSetting : public Setting {
 private:
     float _defaultValue;
@@ -432,6 +465,11 @@ public:
     FloatSetting* home_mpos;
     IntSetting*   microsteps;
     IntSetting*   stallguard;
+    EnumSetting*  shaper_type;
+    FloatSetting* shaper_frequency;
+    FloatSetting* shaper_damping;
+    FloatSetting* encoder_resolution;
+    FloatSetting* encoder_max_error;
 
     AxisSettings(const char* axisName);
 };
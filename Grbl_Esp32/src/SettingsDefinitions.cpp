@@ -13,6 +13,9 @@ StringSetting* build_info;
 IntSetting* pulse_microseconds;
 IntSetting* stepper_idle_lock_time;
 
+FloatSetting* step_direction_delay;
+IntSetting*   step_enable_delay;
+
 AxisMaskSetting* step_invert_mask;
 AxisMaskSetting* dir_invert_mask;
 // TODO Settings - need to call st_generate_step_invert_masks;
@@ -56,6 +59,16 @@ FloatSetting* spindle_pwm_min_value;
 FloatSetting* spindle_pwm_max_value;
 IntSetting*   spindle_pwm_bit_precision;
 
+IntSetting*   spindle_encoder_ppr;
+FloatSetting* spindle_at_speed_tolerance;
+FloatSetting* spindle_at_speed_timeout;
+
+FloatSetting* spindle_rated_current;
+FloatSetting* spindle_adaptive_load;
+FloatSetting* spindle_adaptive_gain;
+IntSetting*   spindle_adaptive_min;
+IntSetting*   spindle_adaptive_max;
+
 EnumSetting* spindle_type;
 
 enum_opt_t spindleTypes = {
@@ -72,6 +85,15 @@ enum_opt_t spindleTypes = {
     // clang-format on
 };
 
+enum_opt_t shaperTypes = {
+    // clang-format off
+    { "NONE", int8_t(ShaperType::None) },
+    { "ZV", int8_t(ShaperType::ZV) },
+    { "ZVD", int8_t(ShaperType::ZVD) },
+    { "EI", int8_t(ShaperType::EI) },
+    // clang-format on
+};
+
 AxisSettings* x_axis_settings;
 AxisSettings* y_axis_settings;
 AxisSettings* z_axis_settings;
@@ -92,6 +114,11 @@ typedef struct {
     float       hold_current;
     uint16_t    microsteps;
     uint16_t    stallguard;
+    int8_t      shaper_type;
+    float       shaper_frequency;
+    float       shaper_damping;
+    float       encoder_resolution;
+    float       encoder_max_error;
 } axis_defaults_t;
 axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_X_STEPS_PER_MM,
@@ -102,7 +129,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_X_CURRENT,
                                       DEFAULT_X_HOLD_CURRENT,
                                       DEFAULT_X_MICROSTEPS,
-                                      DEFAULT_X_STALLGUARD },
+                                      DEFAULT_X_STALLGUARD,
+                                      DEFAULT_X_SHAPER_TYPE,
+                                      DEFAULT_X_SHAPER_FREQUENCY,
+                                      DEFAULT_X_SHAPER_DAMPING,
+                                      DEFAULT_X_ENCODER_RESOLUTION,
+                                      DEFAULT_X_ENCODER_MAX_ERROR },
                                     { "Y",
                                       DEFAULT_Y_STEPS_PER_MM,
                                       DEFAULT_Y_MAX_RATE,
@@ -112,7 +144,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_Y_CURRENT,
                                       DEFAULT_Y_HOLD_CURRENT,
                                       DEFAULT_Y_MICROSTEPS,
-                                      DEFAULT_Y_STALLGUARD },
+                                      DEFAULT_Y_STALLGUARD,
+                                      DEFAULT_Y_SHAPER_TYPE,
+                                      DEFAULT_Y_SHAPER_FREQUENCY,
+                                      DEFAULT_Y_SHAPER_DAMPING,
+                                      DEFAULT_Y_ENCODER_RESOLUTION,
+                                      DEFAULT_Y_ENCODER_MAX_ERROR },
                                     { "Z",
                                       DEFAULT_Z_STEPS_PER_MM,
                                       DEFAULT_Z_MAX_RATE,
@@ -122,7 +159,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_Z_CURRENT,
                                       DEFAULT_Z_HOLD_CURRENT,
                                       DEFAULT_Z_MICROSTEPS,
-                                      DEFAULT_Z_STALLGUARD },
+                                      DEFAULT_Z_STALLGUARD,
+                                      DEFAULT_Z_SHAPER_TYPE,
+                                      DEFAULT_Z_SHAPER_FREQUENCY,
+                                      DEFAULT_Z_SHAPER_DAMPING,
+                                      DEFAULT_Z_ENCODER_RESOLUTION,
+                                      DEFAULT_Z_ENCODER_MAX_ERROR },
                                     { "A",
                                       DEFAULT_A_STEPS_PER_MM,
                                       DEFAULT_A_MAX_RATE,
@@ -132,7 +174,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_A_CURRENT,
                                       DEFAULT_A_HOLD_CURRENT,
                                       DEFAULT_A_MICROSTEPS,
-                                      DEFAULT_A_STALLGUARD },
+                                      DEFAULT_A_STALLGUARD,
+                                      DEFAULT_A_SHAPER_TYPE,
+                                      DEFAULT_A_SHAPER_FREQUENCY,
+                                      DEFAULT_A_SHAPER_DAMPING,
+                                      DEFAULT_A_ENCODER_RESOLUTION,
+                                      DEFAULT_A_ENCODER_MAX_ERROR },
                                     { "B",
                                       DEFAULT_B_STEPS_PER_MM,
                                       DEFAULT_B_MAX_RATE,
@@ -142,7 +189,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_B_CURRENT,
                                       DEFAULT_B_HOLD_CURRENT,
                                       DEFAULT_B_MICROSTEPS,
-                                      DEFAULT_B_STALLGUARD },
+                                      DEFAULT_B_STALLGUARD,
+                                      DEFAULT_B_SHAPER_TYPE,
+                                      DEFAULT_B_SHAPER_FREQUENCY,
+                                      DEFAULT_B_SHAPER_DAMPING,
+                                      DEFAULT_B_ENCODER_RESOLUTION,
+                                      DEFAULT_B_ENCODER_MAX_ERROR },
                                     { "C",
                                       DEFAULT_C_STEPS_PER_MM,
                                       DEFAULT_C_MAX_RATE,
@@ -152,7 +204,12 @@ axis_defaults_t axis_defaults[] = { { "X",
                                       DEFAULT_C_CURRENT,
                                       DEFAULT_C_HOLD_CURRENT,
                                       DEFAULT_C_MICROSTEPS,
-                                      DEFAULT_C_STALLGUARD } };
+                                      DEFAULT_C_STALLGUARD,
+                                      DEFAULT_C_SHAPER_TYPE,
+                                      DEFAULT_C_SHAPER_FREQUENCY,
+                                      DEFAULT_C_SHAPER_DAMPING,
+                                      DEFAULT_C_ENCODER_RESOLUTION,
+                                      DEFAULT_C_ENCODER_MAX_ERROR } };
 
 // Construct e.g. X_MAX_RATE from axisName "X" and tail "_MAX_RATE"
 // in dynamically allocated memory that will not be freed.
@@ -239,6 +296,11 @@ void make_settings() {
     make_coordinate(CoordIndex::G28, "G28");
     make_coordinate(CoordIndex::G30, "G30");
 
+    offset_table = new OffsetTable("OffsetTable");
+    if (!offset_table->load()) {
+        offset_table->setDefault();
+    }
+
     verbose_errors = new FlagSetting(EXTENDED, WG, NULL, "Errors/Verbose", DEFAULT_VERBOSE_ERRORS);
 
     // number_axis = new IntSetting(EXTENDED, WG, NULL, "NumberAxis", N_AXIS, 0, 6, NULL, true);
@@ -265,6 +327,41 @@ void make_settings() {
         setting->setAxis(axis);
         axis_settings[axis]->stallguard = setting;
     }
+
+    for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
+        def          = &axis_defaults[axis];
+        auto setting = new FloatSetting(
+            EXTENDED, WG, NULL, makename(def->name, "Encoder/MaxError"), def->encoder_max_error, 0.0, 100.0);  // mm
+        setting->setAxis(axis);
+        axis_settings[axis]->encoder_max_error = setting;
+    }
+    for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
+        def          = &axis_defaults[axis];
+        auto setting = new FloatSetting(
+            EXTENDED, WG, NULL, makename(def->name, "Encoder/Resolution"), def->encoder_resolution, 0.0, 100000.0);  // counts/mm
+        setting->setAxis(axis);
+        axis_settings[axis]->encoder_resolution = setting;
+    }
+    for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
+        def          = &axis_defaults[axis];
+        auto setting = new FloatSetting(EXTENDED, WG, NULL, makename(def->name, "Shaper/Damping"), def->shaper_damping, 0.0, 0.5);
+        setting->setAxis(axis);
+        axis_settings[axis]->shaper_damping = setting;
+    }
+    for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
+        def          = &axis_defaults[axis];
+        auto setting = new FloatSetting(
+            EXTENDED, WG, NULL, makename(def->name, "Shaper/Frequency"), def->shaper_frequency, 5.0, 500.0);  // Hz
+        setting->setAxis(axis);
+        axis_settings[axis]->shaper_frequency = setting;
+    }
+    for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
+        def          = &axis_defaults[axis];
+        auto setting = new EnumSetting(
+            NULL, EXTENDED, WG, NULL, makename(def->name, "Shaper/Type"), def->shaper_type, &shaperTypes);
+        setting->setAxis(axis);
+        axis_settings[axis]->shaper_type = setting;
+    }
     for (axis = MAX_N_AXIS - 1; axis >= 0; axis--) {
         def          = &axis_defaults[axis];
         auto setting = new IntSetting(
@@ -333,6 +430,20 @@ void make_settings() {
     spindle_delay_spinup   = new FloatSetting(EXTENDED, WG, NULL, "Spindle/Delay/SpinUp", DEFAULT_SPINDLE_DELAY_SPINUP, 0, 30);
     spindle_delay_spindown = new FloatSetting(EXTENDED, WG, NULL, "Spindle/Delay/SpinDown", DEFAULT_SPINDLE_DELAY_SPINUP, 0, 30);
 
+    spindle_encoder_ppr = new IntSetting(EXTENDED, WG, NULL, "Spindle/Encoder/PPR", DEFAULT_SPINDLE_ENCODER_PPR, 1, 100000);
+
+    spindle_at_speed_tolerance =
+        new FloatSetting(EXTENDED, WG, NULL, "Spindle/AtSpeed/Tolerance", DEFAULT_SPINDLE_AT_SPEED_TOLERANCE, 0.0, 50.0);
+    spindle_at_speed_timeout = new FloatSetting(EXTENDED, WG, NULL, "Spindle/AtSpeed/Timeout", DEFAULT_SPINDLE_AT_SPEED_TIMEOUT, 0.0, 60.0);
+
+    spindle_rated_current = new FloatSetting(EXTENDED, WG, NULL, "Spindle/RatedCurrent", DEFAULT_SPINDLE_RATED_CURRENT, 0.0, 100.0);
+    spindle_adaptive_load = new FloatSetting(EXTENDED, WG, NULL, "Spindle/Adaptive/Load", DEFAULT_SPINDLE_ADAPTIVE_LOAD, 0.0, 200.0);
+    spindle_adaptive_gain = new FloatSetting(EXTENDED, WG, NULL, "Spindle/Adaptive/Gain", DEFAULT_SPINDLE_ADAPTIVE_GAIN, 0.01, 1.0);
+    spindle_adaptive_min  = new IntSetting(
+        EXTENDED, WG, NULL, "Spindle/Adaptive/MinFeed", DEFAULT_SPINDLE_ADAPTIVE_MIN, FeedOverride::Min, FeedOverride::Default);
+    spindle_adaptive_max  = new IntSetting(
+        EXTENDED, WG, NULL, "Spindle/Adaptive/MaxFeed", DEFAULT_SPINDLE_ADAPTIVE_MAX, FeedOverride::Default, FeedOverride::Max);
+
     spindle_enbl_off_with_zero_speed =
         new FlagSetting(GRBL, WG, NULL, "Spindle/Enable/OffWithSpeed", DEFAULT_SPINDLE_ENABLE_OFF_WITH_ZERO_SPEED);
 
@@ -377,6 +488,8 @@ void make_settings() {
     step_invert_mask       = new AxisMaskSetting(GRBL, WG, "2", "Stepper/StepInvert", DEFAULT_STEPPING_INVERT_MASK);
     stepper_idle_lock_time = new IntSetting(GRBL, WG, "1", "Stepper/IdleTime", DEFAULT_STEPPER_IDLE_LOCK_TIME, 0, 255);
     pulse_microseconds     = new IntSetting(GRBL, WG, "0", "Stepper/Pulse", DEFAULT_STEP_PULSE_MICROSECONDS, 3, 1000);
+    step_direction_delay   = new FloatSetting(EXTENDED, WG, NULL, "Stepper/Delay/Direction", DEFAULT_STEP_DIRECTION_DELAY, 0, 20);
+    step_enable_delay      = new IntSetting(EXTENDED, WG, NULL, "Stepper/Delay/Enable", DEFAULT_STEP_ENABLE_DELAY, 0, 1000000);
     spindle_type           = new EnumSetting(NULL, EXTENDED, WG, NULL, "Spindle/Type", static_cast<int8_t>(SPINDLE_TYPE), &spindleTypes);
     stallguard_debug_mask  = new AxisMaskSetting(EXTENDED, WG, NULL, "Report/StallGuard", 0, checkStallguardDebugMask);
 
@@ -21,6 +21,9 @@ extern StringSetting* build_info;
 extern IntSetting* pulse_microseconds;
 extern IntSetting* stepper_idle_lock_time;
 
+extern FloatSetting* step_direction_delay;
+extern IntSetting*   step_enable_delay;
+
 extern AxisMaskSetting* step_invert_mask;
 extern AxisMaskSetting* dir_invert_mask;
 extern AxisMaskSetting* homing_dir_mask;
@@ -58,6 +61,16 @@ extern FloatSetting* spindle_pwm_min_value;
 extern FloatSetting* spindle_pwm_max_value;
 extern IntSetting*   spindle_pwm_bit_precision;
 
+extern IntSetting*   spindle_encoder_ppr;
+extern FloatSetting* spindle_at_speed_tolerance;
+extern FloatSetting* spindle_at_speed_timeout;
+
+extern FloatSetting* spindle_rated_current;
+extern FloatSetting* spindle_adaptive_load;
+extern FloatSetting* spindle_adaptive_gain;
+extern IntSetting*   spindle_adaptive_min;
+extern IntSetting*   spindle_adaptive_max;
+
 extern EnumSetting* spindle_type;
 
 extern AxisMaskSetting* stallguard_debug_mask;
@@ -0,0 +1,281 @@
+/*
+  SimulatedInputs.cpp - a virtual machine that drives the limit, probe and control inputs
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#ifdef SIMULATED_INPUTS
+
+enum class SimEvent : uint8_t {
+    None = 0,  // Drops the pending events
+    Door,
+    Close,
+    Hold,
+    Start,
+    Reset,
+};
+
+static const char* sim_event_names[] = { "", "Door", "Close", "Hold", "Start", "Reset" };
+
+struct SimSchedule {
+    SimEvent event;
+    int8_t   axis;      // -1 fires at time, otherwise when the axis reaches position
+    bool     below;     // The axis was below position when the event was scheduled
+    int64_t  time;      // esp_timer_get_time()
+    int32_t  position;  // steps
+};
+
+static volatile int32_t sim_position[MAX_N_AXIS];  // steps
+static int32_t          limit_low[MAX_N_AXIS];     // Switch positions in steps
+static int32_t          limit_high[MAX_N_AXIS];
+static volatile int8_t  probe_axis = -1;
+static volatile int32_t probe_level;  // steps
+static volatile bool    door_open = false;
+
+static xQueueHandle sim_event_queue = NULL;
+
+void IRAM_ATTR sim_inputs_step(uint8_t step_mask, uint8_t dir_mask) {
+    for (uint8_t axis = X_AXIS; step_mask; axis++, step_mask >>= 1) {
+        if (step_mask & 1) {
+            if (dir_mask & bit(axis)) {
+                sim_position[axis]--;
+            } else {
+                sim_position[axis]++;
+            }
+        }
+    }
+}
+
+AxisMask IRAM_ATTR sim_inputs_limits() {
+    AxisMask state = 0;
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        if (sim_position[axis] <= limit_low[axis] || sim_position[axis] >= limit_high[axis]) {
+            state |= bit(axis);
+        }
+    }
+    return state;
+}
+
+bool IRAM_ATTR sim_inputs_probe() {
+    int8_t axis = probe_axis;
+    return axis >= 0 && sim_position[axis] <= probe_level;
+}
+
+ControlPins sim_inputs_control() {
+    ControlPins pins;
+    pins.value          = 0;
+    pins.bit.safetyDoor = door_open;
+    return pins;
+}
+
+float sim_inputs_position(uint8_t axis) {
+    return sim_position[axis] / axis_settings[axis]->steps_per_mm->get();
+}
+
+void sim_inputs_set_position(uint8_t axis, float mm) {
+    sim_position[axis] = lroundf(mm * axis_settings[axis]->steps_per_mm->get());
+}
+
+void sim_inputs_set_probe(int8_t axis, float mm) {
+    probe_axis = -1;  // The stepper ISR must not compare while the surface changes
+    if (axis >= 0) {
+        probe_level = lroundf(mm * axis_settings[axis]->steps_per_mm->get());
+        probe_axis  = axis;
+    }
+}
+
+static void sim_fire(SimEvent event) {
+    ControlPins pins;
+    pins.value = 0;
+    switch (event) {
+        case SimEvent::Door:
+            door_open           = true;
+            pins.bit.safetyDoor = true;
+            break;
+        case SimEvent::Close:
+            door_open = false;
+            break;
+        case SimEvent::Hold:
+            pins.bit.feedHold = true;
+            break;
+        case SimEvent::Start:
+            pins.bit.cycleStart = true;
+            break;
+        case SimEvent::Reset:
+            pins.bit.reset = true;
+            break;
+        default:
+            break;
+    }
+    if (pins.value) {
+        system_exec_control_pin(pins);
+    }
+}
+
+static float sim_distance(const int32_t* from) {
+    float distance = 0.0;
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        float mm = (sim_position[axis] - from[axis]) / axis_settings[axis]->steps_per_mm->get();
+        distance += mm * mm;
+    }
+    return sqrtf(distance);
+}
+
+// Fires the events when they are due, and checks the switches for hard limits like the pin interrupts would
+static void simInputsTask(void* pvParameters) {
+    SimSchedule pending[SIM_INPUTS_EVENTS];
+    uint8_t     n_pending   = 0;
+    AxisMask    last_limits = 0;
+    SimEvent    stopping    = SimEvent::None;  // Hold or Door event that the machine is stopping for
+    int64_t     stop_time   = 0;
+    int32_t     stop_from[MAX_N_AXIS];
+    while (true) {
+        SimSchedule schedule;
+        while (xQueueReceive(sim_event_queue, &schedule, 0) == pdTRUE) {
+            if (schedule.event == SimEvent::None) {
+                n_pending = 0;
+            } else if (n_pending < SIM_INPUTS_EVENTS) {
+                pending[n_pending++] = schedule;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        for (uint8_t i = 0; i < n_pending;) {
+            SimSchedule& s = pending[i];
+            bool         due;
+            if (s.axis < 0) {
+                due = now >= s.time;
+            } else {
+                due = s.below ? sim_position[s.axis] >= s.position : sim_position[s.axis] <= s.position;
+            }
+            if (!due) {
+                i++;
+                continue;
+            }
+            if (s.event == SimEvent::Hold || s.event == SimEvent::Door) {
+                stopping  = s.event;
+                stop_time = now;
+                for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+                    stop_from[axis] = sim_position[axis];
+                }
+            }
+            sim_fire(s.event);
+            pending[i] = pending[--n_pending];
+        }
+
+        if (stopping != SimEvent::None &&
+            (sys.suspend.bit.holdComplete || sys.state == State::Idle || sys.state == State::Alarm)) {
+            grbl_msg_sendf(CLIENT_ALL,
+                           MsgLevel::Info,
+                           "Sim %s stopped in %.1fms and %.3fmm",
+                           sim_event_names[int(stopping)],
+                           (esp_timer_get_time() - stop_time) / 1000.0,
+                           sim_distance(stop_from));
+            stopping = SimEvent::None;
+        }
+
+        AxisMask limits = sim_inputs_limits() & ((1 << number_axis->get()) - 1);
+        if (hard_limits->get() && (limits & ~last_limits)) {
+            isr_limit_switches();
+        }
+        last_limits = limits;
+
+        vTaskDelay(SIM_INPUTS_PERIOD_MS / portTICK_PERIOD_MS);
+        static UBaseType_t uxHighWaterMark = 0;
+        reportTaskStackSize(uxHighWaterMark);
+    }
+}
+
+void sim_inputs_init() {
+    sim_inputs_sync();
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        sim_position[axis] = limit_low[axis] / 2 + limit_high[axis] / 2;
+    }
+    if (sim_event_queue == NULL) {
+        sim_event_queue = xQueueCreate(SIM_INPUTS_EVENTS, sizeof(SimSchedule));
+        xTaskCreate(simInputsTask,
+                    "simInputsTask",
+                    2048,
+                    NULL,
+                    5,  // priority
+                    NULL);
+    }
+    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Limits, probe and door simulated");
+}
+
+void sim_inputs_sync() {
+    auto n_axis  = number_axis->get();
+    auto mask    = homing_dir_mask->get();
+    auto pulloff = homing_pulloff->get();
+    for (uint8_t axis = X_AXIS; axis < MAX_N_AXIS; axis++) {
+        if (axis >= n_axis) {
+            limit_low[axis]  = INT32_MIN;
+            limit_high[axis] = INT32_MAX;
+            continue;
+        }
+        float steps  = axis_settings[axis]->steps_per_mm->get();
+        float mpos   = axis_settings[axis]->home_mpos->get();
+        float travel = axis_settings[axis]->max_travel->get() + pulloff;  // The far switch is beyond the soft limits
+        if (bit_istrue(mask, bit(axis))) {
+            limit_low[axis]  = lroundf(mpos * steps);
+            limit_high[axis] = lroundf((mpos + travel) * steps);
+        } else {
+            limit_low[axis]  = lroundf((mpos - travel) * steps);
+            limit_high[axis] = lroundf(mpos * steps);
+        }
+    }
+}
+
+Error sim_inputs_schedule(const char* spec) {
+    SimSchedule schedule = {};
+    schedule.axis        = -1;
+    schedule.time        = esp_timer_get_time();
+    if (spec && *spec) {
+        const char* at  = strchr(spec, '@');
+        size_t      len = at ? at - spec : strlen(spec);
+        for (uint8_t e = uint8_t(SimEvent::Door); e <= uint8_t(SimEvent::Reset); e++) {
+            if (strlen(sim_event_names[e]) == len && strncasecmp(spec, sim_event_names[e], len) == 0) {
+                schedule.event = SimEvent(e);
+            }
+        }
+        if (schedule.event == SimEvent::None) {
+            return Error::InvalidStatement;
+        }
+        if (at) {
+            const char* axis_letters = "XYZABC";
+            const char* axis_letter  = at[1] ? strchr(axis_letters, toupper(at[1])) : NULL;
+            uint8_t     char_counter = axis_letter ? 2 : 1;
+            float       value;
+            if (!read_float(at, &char_counter, &value) || at[char_counter] != '\0') {
+                return Error::BadNumberFormat;
+            }
+            if (axis_letter) {
+                schedule.axis     = axis_letter - axis_letters;
+                schedule.position = lroundf(value * axis_settings[schedule.axis]->steps_per_mm->get());
+                schedule.below    = sim_position[schedule.axis] < schedule.position;
+            } else {
+                schedule.time += int64_t(value * 1000000.0);
+            }
+        }
+    }
+    if (xQueueSend(sim_event_queue, &schedule, 0) != pdTRUE) {
+        return Error::Overflow;
+    }
+    return Error::Ok;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+  SimulatedInputs.h - a virtual machine that drives the limit, probe and control inputs
+  Part of Grbl_ESP32
+
+  With SIMULATED_INPUTS defined, the step pulses of the stepper ISR
+  move a virtual machine, and the limit switches, the probe and the
+  safety door are read from it as well as from their pins. That makes
+  homing, probing and feed hold repeatable on a board without any
+  switches, like test_drive.h, so they can be timed and compared
+  between builds. SPINDLE_ENCODER_SIMULATED does the same for the
+  spindle input.
+
+  Each axis has a switch at $X/Home/Mpos, on the side it homes to,
+  and another one $X/MaxTravel plus $Homing/Pulloff away. The
+  switches are placed from the settings at every reset. At power up
+  the machine is half way between them.
+
+  $Sim/Position=X-10Y-20   moves the virtual machine, without steps
+  $Sim/Position            reports where it is
+  $Sim/Probe=Z-30          probe triggers at Z-30 and below
+  $Sim/Probe               no probe surface
+  $Sim/Event=Hold@1.5      feed hold 1.5 seconds from now
+  $Sim/Event=Door@X-50     door opens when X reaches -50
+  $Sim/Event=Close         door closes now
+  $Sim/Event               drops the pending events
+
+  The events are Door, Close, Hold, Start and Reset. After a Hold or
+  Door event, the time and distance the machine needed to stop are
+  reported.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+const int SIM_INPUTS_EVENTS    = 8;  // Pending events
+const int SIM_INPUTS_PERIOD_MS = 1;  // Event and hard limit check interval
+
+// Place the machine between its switches and start the event task
+void sim_inputs_init();
+
+// Place the switches from the settings
+void sim_inputs_sync();
+
+// Move the virtual machine. Called by the stepper ISR with the step and direction bits.
+void sim_inputs_step(uint8_t step_mask, uint8_t dir_mask);
+
+// Switches that the virtual machine is on, bits indexed by axis
+AxisMask sim_inputs_limits();
+
+// True if the virtual machine is on the probe surface
+bool sim_inputs_probe();
+
+// Control inputs of the virtual machine, the safety door for now
+ControlPins sim_inputs_control();
+
+// Position of the virtual machine, in mm
+float sim_inputs_position(uint8_t axis);
+void  sim_inputs_set_position(uint8_t axis, float mm);
+
+// The probe triggers at mm and below on the axis. An axis of -1 removes the surface.
+void sim_inputs_set_probe(int8_t axis, float mm);
+
+// Schedule an event like Hold@1.5 or Door@X-50. An empty one drops the pending events.
+Error sim_inputs_schedule(const char* spec);
@@ -0,0 +1,160 @@
+/*
+  SpindleEncoder.cpp - spindle position feedback for synchronized motion
+  Part of Grbl_ESP32
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#include <driver/pcnt.h>
+
+const pcnt_unit_t SPINDLE_ENCODER_PCNT_UNIT = PCNT_UNIT_0;
+const int16_t     SPINDLE_ENCODER_PCNT_LIM  = 30000;  // The counter is folded into encoder_base at these limits
+
+static bool encoder_ok = false;
+
+#ifndef SPINDLE_ENCODER_SIMULATED
+static volatile int64_t encoder_base = 0;  // Counts of the full counter cycles
+
+static int64_t sample_time  = 0;  // usec
+static int64_t sample_count = 0;
+static float   sample_rpm   = 0.0;
+
+static void IRAM_ATTR spindle_encoder_isr(void* arg) {
+    uint32_t status = PCNT.status_unit[SPINDLE_ENCODER_PCNT_UNIT].val;
+    if (status & PCNT_STATUS_H_LIM_M) {
+        encoder_base += SPINDLE_ENCODER_PCNT_LIM;
+    }
+    if (status & PCNT_STATUS_L_LIM_M) {
+        encoder_base -= SPINDLE_ENCODER_PCNT_LIM;
+    }
+}
+#endif
+
+void spindle_encoder_init() {
+#ifdef SPINDLE_ENCODER_SIMULATED
+    encoder_ok = true;
+    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Spindle encoder simulated");
+#else
+    if (SPINDLE_ENCODER_A_PIN == UNDEFINED_PIN || SPINDLE_ENCODER_B_PIN == UNDEFINED_PIN) {
+        return;
+    }
+    pcnt_config_t config;
+    config.pulse_gpio_num = SPINDLE_ENCODER_A_PIN;
+    config.ctrl_gpio_num  = SPINDLE_ENCODER_B_PIN;
+    config.channel        = PCNT_CHANNEL_0;
+    config.unit           = SPINDLE_ENCODER_PCNT_UNIT;
+    config.pos_mode       = PCNT_COUNT_INC;  // A rising
+    config.neg_mode       = PCNT_COUNT_DEC;  // A falling
+    config.lctrl_mode     = PCNT_MODE_KEEP;  // B low
+    config.hctrl_mode     = PCNT_MODE_REVERSE;
+    config.counter_h_lim  = SPINDLE_ENCODER_PCNT_LIM;
+    config.counter_l_lim  = -SPINDLE_ENCODER_PCNT_LIM;
+    pcnt_unit_config(&config);
+
+    pcnt_set_filter_value(SPINDLE_ENCODER_PCNT_UNIT, 100);  // 1.25 usec at 80MHz
+    pcnt_filter_enable(SPINDLE_ENCODER_PCNT_UNIT);
+    pcnt_event_enable(SPINDLE_ENCODER_PCNT_UNIT, PCNT_EVT_H_LIM);
+    pcnt_event_enable(SPINDLE_ENCODER_PCNT_UNIT, PCNT_EVT_L_LIM);
+    pcnt_counter_pause(SPINDLE_ENCODER_PCNT_UNIT);
+    pcnt_counter_clear(SPINDLE_ENCODER_PCNT_UNIT);
+    pcnt_isr_service_install(0);  // Shared with the axis encoders, so it may be installed already
+    pcnt_isr_handler_add(SPINDLE_ENCODER_PCNT_UNIT, spindle_encoder_isr, NULL);
+    pcnt_counter_resume(SPINDLE_ENCODER_PCNT_UNIT);
+
+    encoder_ok = true;
+    grbl_msg_sendf(CLIENT_SERIAL,
+                   MsgLevel::Info,
+                   "Spindle encoder A:%s B:%s",
+                   pinName(SPINDLE_ENCODER_A_PIN).c_str(),
+                   pinName(SPINDLE_ENCODER_B_PIN).c_str());
+    sample_time = esp_timer_get_time();
+#endif
+}
+
+bool spindle_encoder_present() {
+    return encoder_ok;
+}
+
+int32_t spindle_encoder_cpr() {
+    return 2 * spindle_encoder_ppr->get();
+}
+
+int64_t spindle_encoder_next_rev(bool reverse) {
+    int64_t count = spindle_encoder_count();
+    int64_t cpr   = spindle_encoder_cpr();
+    int64_t below = count - count % cpr;  // Toward zero
+    if (below > count) {
+        below -= cpr;
+    }
+    return (reverse || below == count) ? below : below + cpr;
+}
+
+float spindle_encoder_revs(int64_t from, int64_t to) {
+    return float(to - from) / spindle_encoder_cpr();
+}
+
+#ifdef SPINDLE_ENCODER_SIMULATED
+// The spindle is assumed to follow its command at once
+int64_t spindle_encoder_count() {
+    static int64_t count    = 0;
+    static float   fraction = 0.0;  // Of a count, not yet in count
+    static int64_t last     = esp_timer_get_time();
+
+    int64_t now    = esp_timer_get_time();
+    float   counts = fraction + spindle_encoder_rpm() * spindle_encoder_cpr() * (now - last) / (60.0 * 1000000.0);
+    float   whole  = floorf(counts);
+    count += int32_t(whole);
+    fraction = counts - whole;
+    last     = now;
+    return count;
+}
+
+float spindle_encoder_rpm() {
+    switch (spindle->get_state()) {
+        case SpindleState::Cw:
+            return sys.spindle_speed;
+        case SpindleState::Ccw:
+            return -sys.spindle_speed;
+        default:
+            return 0.0;
+    }
+}
+#else
+int64_t spindle_encoder_count() {
+    if (!encoder_ok) {
+        return 0;
+    }
+    int16_t count;
+    int64_t base;
+    do {  // The counter may fold into encoder_base in between
+        base = encoder_base;
+        pcnt_get_counter_value(SPINDLE_ENCODER_PCNT_UNIT, &count);
+    } while (base != encoder_base);
+    return base + count;
+}
+
+// Averaged over at least SPINDLE_ENCODER_RPM_PERIOD_MS
+float spindle_encoder_rpm() {
+    int64_t now = esp_timer_get_time();
+    if (now - sample_time >= SPINDLE_ENCODER_RPM_PERIOD_MS * 1000) {
+        int64_t count = spindle_encoder_count();
+        sample_rpm    = spindle_encoder_revs(sample_count, count) * (60.0 * 1000000.0) / (now - sample_time);
+        sample_count  = count;
+        sample_time   = now;
+    }
+    return sample_rpm;
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+  SpindleEncoder.h - spindle position feedback for synchronized motion
+  Part of Grbl_ESP32
+
+  A quadrature encoder on the spindle is counted by the ESP32 pulse
+  counter (PCNT) on SPINDLE_ENCODER_A_PIN and SPINDLE_ENCODER_B_PIN.
+  Both edges of A are counted and B gives the direction, so there are
+  2 x $Spindle/Encoder/PPR counts per revolution. The position counts
+  up while the spindle turns M3 (swap A and B if it does not).
+
+  With SPINDLE_ENCODER_SIMULATED defined instead, the position is
+  integrated from the commanded spindle speed. That allows G33/G84 to
+  be tried out on a machine, or a bench board, without an encoder.
+  G33 and G84 are only built with SPINDLE_SYNC defined in Config.h.
+
+  Grbl_ESP32 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+const int SPINDLE_ENCODER_RPM_PERIOD_MS = 20;  // Minimum time between speed samples
+
+void spindle_encoder_init();
+
+// True if there is an encoder (or the simulated one) to synchronize with
+bool spindle_encoder_present();
+
+// Spindle position in counts since spindle_encoder_init(), positive for M3. It is kept in
+// 64 bits, as a long threading job can turn the spindle past 32 bits of counts.
+int64_t spindle_encoder_count();
+
+// The count of the next whole revolution the spindle reaches, turning M4 if reverse
+int64_t spindle_encoder_next_rev(bool reverse);
+
+// Revolutions between two counts. Only the difference is made a float, so it keeps its
+// resolution however far the spindle has turned.
+float spindle_encoder_revs(int64_t from, int64_t to);
+
+// Counts per revolution
+int32_t spindle_encoder_cpr();
+
+// Spindle speed in rpm, negative for M4
+float spindle_encoder_rpm();
@@ -119,10 +119,8 @@ namespace Spindles {
         //  Recv: 01 03 0004 095D 0000
         //                   ---- = 2397 (val #1)
 
-        // TODO: What are we going to do with this? Update sys.spindle_speed? Update vfd state?
         return [](const uint8_t* response, Spindles::VFD* vfd) -> bool {
-            uint16_t rpm = (uint16_t(response[4]) << 8) | uint16_t(response[5]);
-            // Set current RPM value? Somewhere?
+            vfd->_reported_rpm = (uint16_t(response[4]) << 8) | uint16_t(response[5]);
             return true;
         };
     }
@@ -145,4 +143,24 @@ namespace Spindles {
         // TODO: What are we going to do with this? Update sys.spindle_speed? Update vfd state?
         return [](const uint8_t* response, Spindles::VFD* vfd) -> bool { return true; };
     }
+
+    H2A::response_parser H2A::get_current_load(ModbusCommand& data) {
+        // NOTE: data length is excluding the CRC16 checksum.
+        data.tx_length = 6;
+        data.rx_length = 6;
+
+        // Send: 01 03 7004 0001
+        data.msg[1] = 0x03;  // READ
+        data.msg[2] = 0x70;  // d0.04 = Output current
+        data.msg[3] = 0x04;
+        data.msg[4] = 0x00;  // Read 1 value
+        data.msg[5] = 0x01;
+
+        //  Recv: 01 03 0002 001C
+        //                   ---- = 2.8A (in 0.1A)
+        return [](const uint8_t* response, Spindles::VFD* vfd) -> bool {
+            vfd->_output_current = (uint16_t(response[4]) << 8) | uint16_t(response[5]);
+            return true;
+        };
+    }
 }
@@ -32,6 +32,7 @@ namespace Spindles {
         response_parser get_max_rpm(ModbusCommand& data) override;
         response_parser get_current_rpm(ModbusCommand& data) override;
         response_parser get_current_direction(ModbusCommand& data) override;
+        response_parser get_current_load(ModbusCommand& data) override;
         response_parser get_status_ok(ModbusCommand& data) override { return nullptr; }
     };
 }
@@ -157,6 +157,43 @@ namespace Spindles {
         data.msg[4] = (value & 0xFF);
     }
 
+    Huanyang::response_parser Huanyang::get_current_rpm(ModbusCommand& data) {
+        // NOTE: data length is excluding the CRC16 checksum.
+        data.tx_length = 6;
+        data.rx_length = 6;
+
+        // data.msg[0] is omitted (modbus address is filled in later)
+        data.msg[1] = 0x04;
+        data.msg[2] = 0x03;
+        data.msg[3] = 0x01;  // Output Frequency * 100. Register 0x03 (RPM) depends on PD143 instead.
+        data.msg[4] = 0x00;
+        data.msg[5] = 0x00;
+
+        return [](const uint8_t* response, Spindles::VFD* vfd) -> bool {
+            uint16_t frequency = (uint16_t(response[4]) << 8) | uint16_t(response[5]);
+            vfd->_reported_rpm = uint32_t(frequency) * 60 / 100;  // The inverse of set_speed_command()
+            return true;
+        };
+    }
+
+    Huanyang::response_parser Huanyang::get_current_load(ModbusCommand& data) {
+        // NOTE: data length is excluding the CRC16 checksum.
+        data.tx_length = 6;
+        data.rx_length = 6;
+
+        // data.msg[0] is omitted (modbus address is filled in later)
+        data.msg[1] = 0x04;
+        data.msg[2] = 0x03;
+        data.msg[3] = 0x02;  // Output Amps * 10
+        data.msg[4] = 0x00;
+        data.msg[5] = 0x00;
+
+        return [](const uint8_t* response, Spindles::VFD* vfd) -> bool {
+            vfd->_output_current = (uint16_t(response[4]) << 8) | uint16_t(response[5]);
+            return true;
+        };
+    }
+
     Huanyang::response_parser Huanyang::get_status_ok(ModbusCommand& data) {
         // NOTE: data length is excluding the CRC16 checksum.
         data.tx_length = 6;
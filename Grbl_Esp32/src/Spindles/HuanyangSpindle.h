@@ -33,6 +33,8 @@ namespace Spindles {
         void direction_command(SpindleState mode, ModbusCommand& data) override;
         void set_speed_command(uint32_t rpm, ModbusCommand& data) override;
 
+        response_parser get_current_rpm(ModbusCommand& data) override;
+        response_parser get_current_load(ModbusCommand& data) override;
         response_parser get_status_ok(ModbusCommand& data) override;
     };
 }
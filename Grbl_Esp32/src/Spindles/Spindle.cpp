@@ -93,6 +93,16 @@ namespace Spindles {
         return false;  // default for basic spindle is false
     }
 
+    // SPINDLE_LOAD_PIN is an analog input where 0..3.3V is 0..100% load,
+    // e.g. the load meter output of a VFD that has no RS485.
+    int32_t Spindle::get_load() {
+#ifdef SPINDLE_LOAD_PIN
+        return int32_t(analogRead(SPINDLE_LOAD_PIN)) * 100 / 4095;
+#else
+        return -1;
+#endif
+    }
+
     void Spindle::sync(SpindleState state, uint32_t rpm) {
         if (sys.state == State::CheckMode) {
             return;
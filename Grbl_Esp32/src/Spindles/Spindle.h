@@ -66,6 +66,7 @@ namespace Spindles {
         virtual void         config_message()                            = 0;
         virtual bool         isRateAdjusted();
         virtual void         sync(SpindleState state, uint32_t rpm);
+        virtual int32_t      get_load();  // percent of the rated load, -1 if unknown
 
         virtual ~Spindle() {}
 
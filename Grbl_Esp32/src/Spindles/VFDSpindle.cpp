@@ -86,13 +86,20 @@ namespace Spindles {
                         }
                         // fall through intentionally:
                     case 2:
-                        parser = instance->get_current_direction(next_cmd);
+                        parser = instance->get_current_load(next_cmd);
                         if (parser) {
                             pollidx = 3;
                             break;
                         }
                         // fall through intentionally:
                     case 3:
+                        parser = instance->get_current_direction(next_cmd);
+                        if (parser) {
+                            pollidx = 4;
+                            break;
+                        }
+                        // fall through intentionally:
+                    case 4:
                         parser  = instance->get_status_ok(next_cmd);
                         pollidx = 1;
 
@@ -192,6 +199,8 @@ namespace Spindles {
             }
 
             if (retry_count == MAX_RETRIES) {
+                instance->_output_current = -1;  // Stale, don't let adaptive feed act on it
+                instance->_reported_rpm   = -1;  // or the at-speed wait
                 if (!unresponsive) {
                     grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Spindle RS485 Unresponsive %d", next_cmd.rx_length);
                     if (next_cmd.critical) {
@@ -322,8 +331,9 @@ namespace Spindles {
             pins_settings_ok = false;
         }
 
-        _min_rpm = rpm_min->get();
-        _max_rpm = rpm_max->get();
+        _min_rpm       = rpm_min->get();
+        _max_rpm       = rpm_max->get();
+        _rated_current = spindle_rated_current->get() * 10;
 
         return pins_settings_ok;
     }
@@ -350,16 +360,19 @@ namespace Spindles {
             if (state == SpindleState::Disable) {
                 sys.spindle_speed = 0;
                 if (_current_state != state) {
-                    mc_dwell(spindle_delay_spindown->get());
+                    delay_sec(spindle_delay_spindown->get(), DELAY_MODE_SYS_SUSPEND);  // As wait_for_speed()
                 }
             } else {
                 if (_current_state != state) {
-                    mc_dwell(spindle_delay_spinup->get());
+                    wait_for_speed(sys.spindle_speed);
                 }
             }
         } else {
             if (_current_rpm != rpm) {
                 set_rpm(rpm);
+                if (state != SpindleState::Disable && spindle_at_speed_tolerance->get() > 0.0) {
+                    wait_for_speed(sys.spindle_speed);
+                }
             }
         }
 
@@ -402,7 +415,14 @@ namespace Spindles {
         }
 
 #ifdef VFD_DEBUG_MODE
-        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Setting spindle speed to %d rpm (%d, %d)", int(rpm), int(_min_rpm), int(_max_rpm));
+        if (!xPortInIsrContext()) {
+            grbl_msg_sendf(CLIENT_SERIAL,
+                           MsgLevel::Info,
+                           "Setting spindle speed to %d rpm (%d, %d)",
+                           int(rpm),
+                           int(_min_rpm),
+                           int(_max_rpm));
+        }
 #endif
 
         // apply override
@@ -432,15 +452,58 @@ namespace Spindles {
 
         rpm_cmd.critical = false;
 
-        if (xQueueSend(vfd_cmd_queue, &rpm_cmd, 0) != pdTRUE) {
+        // The stepper ISR sets the speed of each segment it loads, and no message can be sent from it
+        if (xPortInIsrContext()) {
+            xQueueSendFromISR(vfd_cmd_queue, &rpm_cmd, NULL);
+        } else if (xQueueSend(vfd_cmd_queue, &rpm_cmd, 0) != pdTRUE) {
             grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "VFD Queue Full");
         }
 
         return rpm;
     }
 
+    // Wait until the rpm reported by the VFD is within $Spindle/AtSpeed/Tolerance of the target,
+    // at most $Spindle/AtSpeed/Timeout. Without a tolerance, or a VFD that does not report the
+    // rpm, wait the fixed $Spindle/Delay/SpinUp instead.
+    // NOTE: This is also called for a speed override or a spindle restore in a feed hold, so it
+    // must not synchronize the planner, which would start the cycle. Spindle::sync() does that
+    // for the g-code, before set_state(). Only the realtime system commands run while it waits.
+    void VFD::wait_for_speed(uint32_t rpm) {
+        if (sys.state == State::CheckMode) {
+            return;
+        }
+        float tolerance = spindle_at_speed_tolerance->get();
+        if (tolerance <= 0.0 || _reported_rpm < 0) {
+            delay_sec(spindle_delay_spinup->get(), DELAY_MODE_SYS_SUSPEND);
+            return;
+        }
+
+        int32_t  margin = rpm * tolerance / 100.0;
+        uint32_t i      = ceil(1000 / DWELL_TIME_STEP * spindle_at_speed_timeout->get());
+        while (i-- > 0) {
+            if (sys.abort || sys.suspend.bit.restartRetract) {
+                return;
+            }
+            int32_t reported = _reported_rpm;
+            if (reported >= 0 && abs(reported - int32_t(rpm)) <= margin) {
+                return;
+            }
+            delay_sec(DWELL_TIME_STEP / 1000.0, DELAY_MODE_SYS_SUSPEND);
+        }
+        grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "Spindle at %d rpm, not at speed %d rpm in time", int(_reported_rpm), int(rpm));
+    }
+
     void VFD::stop() { set_mode(SpindleState::Disable, false); }
 
+    // The output current as a percentage of $Spindle/RatedCurrent
+    int32_t VFD::get_load() {
+        int32_t current = _output_current;
+        if (current < 0 || _rated_current == 0) {
+            return Spindle::get_load();
+        }
+        return current * 100 / int32_t(_rated_current);
+    }
+
     // state is cached rather than read right now to prevent delays
     SpindleState VFD::get_state() { return _current_state; }
 
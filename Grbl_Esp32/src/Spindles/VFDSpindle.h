@@ -30,15 +30,17 @@ namespace Spindles {
         static const int MAX_RETRIES            = 3;   // otherwise the spindle is marked 'unresponsive'
 
         bool set_mode(SpindleState mode, bool critical);
+        void wait_for_speed(uint32_t rpm);
         bool get_pins_and_settings();
 
         uint8_t _txd_pin;
         uint8_t _rxd_pin;
         uint8_t _rts_pin;
 
-        uint32_t _current_rpm  = 0;
-        bool     _task_running = false;
-        bool     vfd_ok        = true;
+        uint32_t _current_rpm   = 0;
+        uint32_t _rated_current = 0;  // in 0.1A
+        bool     _task_running  = false;
+        bool     vfd_ok         = true;
 
         static QueueHandle_t vfd_cmd_queue;
         static TaskHandle_t  vfd_cmdTaskHandle;
@@ -67,6 +69,7 @@ namespace Spindles {
         virtual response_parser get_max_rpm(ModbusCommand& data) { return nullptr; }
         virtual response_parser get_current_rpm(ModbusCommand& data) { return nullptr; }
         virtual response_parser get_current_direction(ModbusCommand& data) { return nullptr; }
+        virtual response_parser get_current_load(ModbusCommand& data) { return nullptr; }
         virtual response_parser get_status_ok(ModbusCommand& data) = 0;
 
     public:
@@ -80,6 +83,8 @@ namespace Spindles {
         // Should hide them and use a member function.
         volatile uint32_t _min_rpm;
         volatile uint32_t _max_rpm;
+        volatile int32_t  _output_current = -1;  // in 0.1A, -1 if not (or no longer) reported
+        volatile int32_t  _reported_rpm   = -1;  // -1 if not (or no longer) reported
 
         void         init();
         void         config_message();
@@ -87,6 +92,7 @@ namespace Spindles {
         SpindleState get_state();
         uint32_t     set_rpm(uint32_t rpm);
         void         stop();
+        int32_t      get_load() override;
 
         virtual ~VFD() {}
     };
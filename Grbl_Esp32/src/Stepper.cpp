@@ -25,6 +25,20 @@
 
 #include "Grbl.h"
 
+#ifdef FLOAT_MATH_CHECK
+#    pragma GCC diagnostic error "-Wdouble-promotion"
+#endif
+
+#ifdef NATIVE_ARCS
+// A chord of an arc segment, after the first one. The ISR loads it into the stepper block when the
+// step events of the chord before it are done.
+typedef struct {
+    uint32_t steps[N_AXIS];
+    uint32_t step_event_count;
+    uint8_t  direction_bits;
+} st_chord_t;
+#endif
+
 // Stores the planner block Bresenham algorithm execution data for the segments in the segment
 // buffer. Normally, this buffer is partially in-use, but, for the worst case scenario, it will
 // never exceed the number of accessible stepper buffer segments (SEGMENT_BUFFER_SIZE-1).
@@ -32,10 +46,23 @@
 // discarded when entirely consumed and completed by the segment buffer. Also, AMASS alters this
 // data for its own use.
 typedef struct {
-    uint32_t steps[MAX_N_AXIS];
+    uint32_t steps[N_AXIS];
     uint32_t step_event_count;
     uint8_t  direction_bits;
     uint8_t  is_pwm_rate_adjusted;  // Tracks motions that require constant laser power/rate
+#ifdef CONSTANT_SURFACE_SPEED
+    uint8_t is_css;  // G96. The spindle speed is sent by st_prep_buffer(), not by the ISR.
+#endif
+#ifdef NATIVE_ARCS
+    uint8_t    n_chords;  // Chords that follow the line above in an arc segment, 0 for any other block
+    st_chord_t chords[ARC_SEGMENT_CHORDS - 1];
+#endif
+#ifdef LINE_TIMING
+    uint32_t line_index;
+    int32_t  line_number;
+    uint32_t sequence;       // Of the planner block
+    uint32_t programmed_us;  // Time at the programmed rate
+#endif
 } st_block_t;
 static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE - 1];
 
@@ -49,6 +76,7 @@ typedef struct {
     uint8_t  st_block_index;   // Stepper block data index. Uses this information to execute this segment.
     uint8_t  amass_level;      // AMASS level for the ISR to execute this segment
     uint16_t spindle_rpm;      // TODO get rid of this.
+    uint8_t  ticks;            // Acceleration ticks it counts for in the segment buffer. More than 1 when cruising.
 } segment_t;
 static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 
@@ -66,12 +94,27 @@ typedef struct {
     uint8_t step_pulse_time;  // Step pulse reset time after step rise
     uint8_t step_outbits;     // The next stepping-bits to be output
     uint8_t dir_outbits;
+    uint8_t dir_output;  // The direction bits currently on the pins
     uint32_t steps[MAX_N_AXIS];
 
+    uint16_t isr_period;       // Ticks of the ISR period that is running
+    bool     shaper_draining;  // The segments are done, but the shaped axes have not caught up yet
+
+    uint8_t shaper_burst[SHAPER_MAX_BURST - 1];  // Shaped steps that follow step_outbits in the same tick
+    uint8_t shaper_n_burst;
+
+    uint32_t pulse_ticks;      // Step pulse length in fStepperTimer ticks
+    uint32_t dir_setup_ticks;  // Direction setup time ahead of a step in fStepperTimer ticks
+    uint32_t dir_setup_usecs;  // The same, rounded up for the I2S stream
+
     uint16_t    step_count;        // Steps remaining in line segment motion
     uint8_t     exec_block_index;  // Tracks the current st_block index. Change indicates new block.
     st_block_t* exec_block;        // Pointer to the block data for the segment being executed
     segment_t*  exec_segment;      // Pointer to the segment being executed
+#ifdef NATIVE_ARCS
+    uint8_t  chord_index;  // Chords of the arc segment loaded so far
+    uint32_t chord_count;  // Step events remaining on the chord being stepped
+#endif
 } stepper_t;
 static stepper_t st;
 
@@ -83,6 +126,15 @@ static uint8_t          segment_next_head;
 // Used to avoid ISR nesting of the "Stepper Driver Interrupt". Should never occur though.
 static volatile uint8_t busy;
 
+#ifdef CONSTANT_SURFACE_SPEED
+// The G96 spindle speed of the running segment, for st_prep_buffer() to send. -1 when no G96
+// segment is running.
+static volatile int32_t css_rpm = -1;
+#endif
+
+// Set between Stepper_Timer_Start() and Stepper_Timer_Stop()
+static volatile bool st_running = false;
+
 // Pointers for the step segment being prepped from the planner buffer. Accessed only by the
 // main program. Pointers may be planning segments or planner blocks ahead of what being executed.
 static plan_block_t* pl_block;       // Pointer to the planner block being prepped
@@ -123,6 +175,25 @@ typedef struct {
     //uint16_t current_spindle_pwm;  // todo remove
     float current_spindle_rpm;
 
+#ifdef CONSTANT_SURFACE_SPEED
+    int32_t  css_rpm;            // The last G96 spindle speed sent, -1 for none
+    uint8_t  css_ovr;            // The spindle speed override it was sent with
+    uint32_t css_spindle_speed;  // sys.spindle_speed it set
+    int64_t  css_time;           // When it was sent (usec)
+#endif
+
+    float   sync_mm_total;  // Length of the spindle synchronized block being prepped (mm)
+    int64_t sync_time;      // When the last prepped segment of that block ends (usec)
+
+#ifdef NATIVE_ARCS
+    int32_t arc_steps[3];    // Where the prepped segments of the arc block end, on axis_0, axis_1 and axis_linear
+    int32_t arc_next[3];     // Where the segment being prepped ends
+    float   arc_angle;       // Where the prepped segments end, from the start of the arc (radians)
+    float   arc_next_angle;  // Where the segment being prepped ends
+    float   arc_chord_mm;    // Longest chord within arc_tolerance of the arc, along the path (mm)
+    bool    arc_chords;      // The stepper block of the arc block has been used for a segment
+#endif
+
 } st_prep_t;
 static st_prep_t prep;
 
@@ -182,17 +253,70 @@ stepper_id_t current_stepper = DEFAULT_STEPPER;
 
 	 The complete step timing should look this...
 		Direction pin is set
-		An optional (via STEP_PULSE_DELAY in config.h) is put after this
+		If the direction changed, the step waits $Stepper/Delay/Direction
 		The step pin is started
 		A pulse length is determine (via option $0 ... pulse_microseconds)
 		The pulse is ended
 		Direction will remain the same until another step occurs with a change in direction.
+	 With GPIO or static I2S stepping the delayed step and the end of the pulse are events of the
+   output scheduler, so the ISR does not spin for them. The I2S stream puts them in its samples.
 
 
 */
 
 static void stepper_pulse_func();
 
+// Output scheduler events
+static void IRAM_ATTR st_step_on_event(uint8_t step_mask, uint8_t dir_mask) {
+    motors_step(step_mask, dir_mask);
+}
+
+static void IRAM_ATTR st_step_off_event(uint8_t arg0, uint8_t arg1) {
+    motors_unstep();
+}
+
+// Cleared by st_go_idle() to cancel a delayed start
+static volatile bool st_start_pending = false;
+
+static void IRAM_ATTR st_start_event(uint8_t arg0, uint8_t arg1) {
+    if (st_start_pending) {
+        st_start_pending = false;
+        Stepper_Timer_Start();
+    }
+}
+
+// Queue an output event, or spin and run it here if the queue is full.
+static void IRAM_ATTR st_output_at(uint64_t time, output_event_func_t func, uint8_t arg0 = 0, uint8_t arg1 = 0) {
+    if (!output_sched_at(time, func, arg0, arg1)) {
+        while (output_sched_now() < time) {
+            NOP();
+        }
+        func(arg0, arg1);
+    }
+}
+
+#ifdef NATIVE_ARCS
+// The steps of an arc segment run along its chords one after another. When the step events of a
+// chord are done, the next one is loaded into the stepper block, as a new block is at a segment load.
+static void IRAM_ATTR st_arc_next_chord(uint8_t shaped, uint8_t n_axis) {
+    while (st.chord_count == 0 && st.chord_index < st.exec_block->n_chords) {
+        st_chord_t* chord               = &st.exec_block->chords[st.chord_index++];
+        st.exec_block->step_event_count = chord->step_event_count;
+        st.exec_block->direction_bits   = chord->direction_bits;
+        for (int axis = 0; axis < 3; axis++) {
+            st.counter[axis] = (st.exec_block->step_event_count >> 1);
+        }
+        st.dir_outbits = (st.exec_block->direction_bits & ~shaped) | (st.dir_outbits & shaped);
+        for (int axis = 0; axis < n_axis; axis++) {
+            st.exec_block->steps[axis] = chord->steps[axis];
+            st.steps[axis]             = chord->steps[axis] >> st.exec_segment->amass_level;
+        }
+        st.chord_count = st.exec_block->step_event_count >> (maxAmassLevel - st.exec_segment->amass_level);
+    }
+    st.chord_count--;
+}
+#endif
+
 // TODO: Replace direct updating of the int32 position counters in the ISR somehow. Perhaps use smaller
 // int8 variables and update position counters only when a segment completes. This can get complicated
 // with probing and homing cycles that require true real-time positions.
@@ -219,31 +343,75 @@ void IRAM_ATTR onStepperDriverTimer(
  * is to keep pulse timing as regular as possible.
  */
 static void stepper_pulse_func() {
-    auto n_axis = number_axis->get();
-
-    motors_step(st.step_outbits, st.dir_outbits);
+    auto    n_axis = number_axis->get();
+    uint8_t shaped = shaper_axes();
+
+    // A direction change is output at once and the step follows it after the
+    // direction setup time: in the I2S stream as dir-only samples, otherwise
+    // as a scheduled event. step_time is when the step pins go on.
+    uint8_t  step_bits  = st.step_outbits;
+    bool     dir_change = st.dir_outbits != st.dir_output;
+    uint64_t step_time  = 0;
+    if (current_stepper == ST_I2S_STREAM) {
+        if (dir_change && st.dir_setup_usecs > 0) {
+            motors_step(0, st.dir_outbits);
+            i2s_out_push_sample(st.dir_setup_usecs);
+        }
+        motors_step(step_bits, st.dir_outbits);
+    } else {
+        step_time = output_sched_now();
+        if (dir_change && st.dir_setup_ticks > 0 && step_bits) {
+            motors_step(0, st.dir_outbits);
+            step_time += st.dir_setup_ticks;
+            st_output_at(step_time, st_step_on_event, step_bits, st.dir_outbits);
+        } else {
+            motors_step(step_bits, st.dir_outbits);
+        }
+    }
+    // The burst of shaped steps that are also due in this tick, each pulse one pulse length after the last one
+    for (uint8_t i = 0; i < st.shaper_n_burst; i++) {
+        if (current_stepper == ST_I2S_STREAM) {
+            i2s_out_push_sample(pulse_microseconds->get());
+            motors_unstep();
+            i2s_out_push_sample(pulse_microseconds->get());
+            motors_step(st.shaper_burst[i], st.dir_outbits);
+        } else {
+            st_output_at(step_time + (2 * i + 2) * st.pulse_ticks, st_step_on_event, st.shaper_burst[i], st.dir_outbits);
+            st_output_at(step_time + (2 * i + 3) * st.pulse_ticks, st_step_off_event);
+        }
+    }
+    st.dir_output = st.dir_outbits;
 
-    // If we are using GPIO stepping as opposed to RMT, record the
-    // time that we turned on the step pins so we can turn them off
-    // at the end of this routine without incurring another interrupt.
-    // This is unnecessary with RMT and I2S stepping since both of
-    // those methods time the turn off automatically.
-    uint64_t step_pulse_start_time = esp_timer_get_time();
+    if (shaped) {
+        shaper_advance(st.isr_period);
+    }
 
     // If there is no step segment, attempt to pop one from the stepper buffer
     if (st.exec_segment == NULL) {
         // Anything in the buffer? If so, load and initialize next step segment.
         if (segment_buffer_head != segment_buffer_tail) {
+            // The motors should have followed the segment that has just ended
+            axis_encoder_check();
             // Initialize new step segment and load number of steps to execute
             st.exec_segment = &segment_buffer[segment_buffer_tail];
             // Initialize step segment timing per step and load number of steps to execute.
-            Stepper_Timer_WritePeriod(st.exec_segment->isrPeriod);
+            st.isr_period = st.exec_segment->isrPeriod;
+            Stepper_Timer_WritePeriod(st.isr_period);
             st.step_count = st.exec_segment->n_step;  // NOTE: Can sometimes be zero when moving slow.
+#ifdef LINE_TIMING
+            line_timing_segment();
+#endif
             // If the new segment starts a new planner block, initialize stepper variables and counters.
             // NOTE: When the segment data index changes, this indicates a new planner block.
             if (st.exec_block_index != st.exec_segment->st_block_index) {
                 st.exec_block_index = st.exec_segment->st_block_index;
                 st.exec_block       = &st_block_buffer[st.exec_block_index];
+#ifdef LINE_TIMING
+                line_timing_block(st.exec_block->line_index,
+                                  st.exec_block->line_number,
+                                  st.exec_block->sequence,
+                                  st.exec_block->programmed_us);
+#endif
                 // Initialize Bresenham line and distance counters
                 // XXX the original code only inits X, Y, Z here, instead of n_axis.  Is that correct?
                 for (int axis = 0; axis < 3; axis++) {
@@ -251,24 +419,61 @@ static void stepper_pulse_func() {
                 }
                 // TODO ABC
             }
-            st.dir_outbits = st.exec_block->direction_bits;
+            // The shaped axes keep the direction of their last output step.
+            st.dir_outbits = (st.exec_block->direction_bits & ~shaped) | (st.dir_outbits & shaped);
             // Adjust Bresenham axis increment counters according to AMASS level.
             for (int axis = 0; axis < n_axis; axis++) {
                 st.steps[axis] = st.exec_block->steps[axis] >> st.exec_segment->amass_level;
             }
+#ifdef NATIVE_ARCS
+            // Step events of the first chord of an arc segment
+            st.chord_index = 0;
+            st.chord_count = st.exec_block->step_event_count >> (maxAmassLevel - st.exec_segment->amass_level);
+#endif
             // Set real-time spindle output as segment is loaded, just prior to the first step.
+#ifdef CONSTANT_SURFACE_SPEED
+            if (st.exec_block->is_css) {
+                css_rpm = st.exec_segment->spindle_rpm;  // Sent by st_css_send_rpm()
+            } else {
+                spindle->set_rpm(st.exec_segment->spindle_rpm);
+                css_rpm = -1;
+            }
+#else
             spindle->set_rpm(st.exec_segment->spindle_rpm);
+#endif
+            if (shaped) {
+                shaper_knot();
+            }
+            st.shaper_draining = false;
         } else {
-            // Segment buffer empty. Shutdown.
-            st_go_idle();
-            if (sys.state != State::Jog) {  // added to prevent ... jog after probing crash
-                // Ensure pwm is set properly upon completion of rate-controlled motion.
-                if (st.exec_block != NULL && st.exec_block->is_pwm_rate_adjusted) {
-                    spindle->set_rpm(0);
+            if (shaped && !st.shaper_draining) {
+                // The commanded motion ends here. Keep the ISR running at a fixed
+                // rate until the shaped axes have followed it.
+                shaper_knot();
+                st.shaper_draining = true;
+                st.isr_period      = SHAPER_DRAIN_TICKS;
+                Stepper_Timer_WritePeriod(st.isr_period);
+            }
+            if (!st.shaper_draining || !shaper_busy()) {
+                // Segment buffer empty. Shutdown.
+                axis_encoder_check();
+#ifdef LINE_TIMING
+                line_timing_stop(plan_get_current_block() == NULL);
+#endif
+                st.shaper_draining = false;
+#ifdef CONSTANT_SURFACE_SPEED
+                css_rpm = -1;  // The spindle speed stays where it is once the motion ends
+#endif
+                st_go_idle();
+                if (sys.state != State::Jog) {  // added to prevent ... jog after probing crash
+                    // Ensure pwm is set properly upon completion of rate-controlled motion.
+                    if (st.exec_block != NULL && st.exec_block->is_pwm_rate_adjusted) {
+                        spindle->set_rpm(0);
+                    }
                 }
+                cycle_stop = true;
+                return;  // Nothing to do but exit.
             }
-            cycle_stop = true;
-            return;  // Nothing to do but exit.
         }
     }
     // Check probing state.
@@ -278,32 +483,85 @@ static void stepper_pulse_func() {
     // Reset step out bits.
     st.step_outbits = 0;
 
-    for (int axis = 0; axis < n_axis; axis++) {
-        // Execute step displacement profile by Bresenham line algorithm
-        st.counter[axis] += st.steps[axis];
-        if (st.counter[axis] > st.exec_block->step_event_count) {
-            st.step_outbits |= bit(axis);
-            st.counter[axis] -= st.exec_block->step_event_count;
-            if (st.exec_block->direction_bits & bit(axis)) {
-                sys_position[axis]--;
-            } else {
-                sys_position[axis]++;
+    if (st.exec_segment != NULL && st.step_count == 0) {
+        // A segment without steps only takes its time, while spindle synchronized motion waits
+        st.exec_segment = NULL;
+        if (++segment_buffer_tail == SEGMENT_BUFFER_SIZE) {
+            segment_buffer_tail = 0;
+        }
+    } else if (st.exec_segment != NULL) {
+#ifdef NATIVE_ARCS
+        if (st.exec_block->n_chords) {
+            st_arc_next_chord(shaped, n_axis);
+        }
+#endif
+        for (int axis = 0; axis < n_axis; axis++) {
+            // Execute step displacement profile by Bresenham line algorithm
+            st.counter[axis] += st.steps[axis];
+            if (st.counter[axis] > st.exec_block->step_event_count) {
+                st.counter[axis] -= st.exec_block->step_event_count;
+                bool negative = st.exec_block->direction_bits & bit(axis);
+                if (bitnum_istrue(shaped, axis)) {
+                    shaper_command_step(axis, negative);  // Put out by shaper_output() below
+                    continue;
+                }
+                st.step_outbits |= bit(axis);
+                if (negative) {
+                    sys_position[axis]--;
+                } else {
+                    sys_position[axis]++;
+                }
             }
         }
-    }
 
-    // During a homing cycle, lock out and prevent desired axes from moving.
-    if (sys.state == State::Homing) {
-        st.step_outbits &= sys.homing_axis_lock;
+        // During a homing cycle, lock out and prevent desired axes from moving.
+        if (sys.state == State::Homing) {
+            st.step_outbits &= sys.homing_axis_lock;
+        }
+        st.step_count--;  // Decrement step events count
+        if (st.step_count == 0) {
+            // Segment is complete. Discard current segment and advance segment indexing.
+            st.exec_segment = NULL;
+            if (++segment_buffer_tail == SEGMENT_BUFFER_SIZE) {
+                segment_buffer_tail = 0;
+            }
+        }
     }
-    st.step_count--;  // Decrement step events count
-    if (st.step_count == 0) {
-        // Segment is complete. Discard current segment and advance segment indexing.
-        st.exec_segment = NULL;
-        if (++segment_buffer_tail == SEGMENT_BUFFER_SIZE) {
-            segment_buffer_tail = 0;
+
+    if (shaped) {
+        // Step the shaped axes towards the shaped position. sys_position follows
+        // the output, so probing and reports see where the axes really are.
+        // RMT cannot start a pulse while one runs. The burst must fit in half
+        // the tick, as the next segment can halve the period for AMASS.
+        uint8_t max_steps = 1;
+        if (current_stepper != ST_RMT) {
+            uint32_t burst_ticks = st.isr_period / 2 - MIN(st.isr_period / 2, st.dir_setup_ticks);
+            max_steps            = constrain(burst_ticks / (2 * st.pulse_ticks), 1, SHAPER_MAX_BURST);
+        }
+        uint8_t shaped_steps[SHAPER_MAX_BURST];
+        uint8_t n_shaped = shaper_output(st.dir_outbits, shaped_steps, max_steps);
+        for (uint8_t i = 0; i < n_shaped; i++) {
+            for (int axis = 0; axis < n_axis; axis++) {
+                if (bitnum_istrue(shaped_steps[i], axis)) {
+                    if (st.dir_outbits & bit(axis)) {
+                        sys_position[axis]--;
+                    } else {
+                        sys_position[axis]++;
+                    }
+                }
+            }
+        }
+        if (n_shaped > 0) {
+            st.step_outbits |= shaped_steps[0];
+            st.shaper_n_burst = n_shaped - 1;
+            memcpy(st.shaper_burst, &shaped_steps[1], st.shaper_n_burst);
+        } else {
+            st.shaper_n_burst = 0;
         }
     }
+#ifdef SIMULATED_INPUTS
+    sim_inputs_step(st.step_outbits, st.dir_outbits);
+#endif
 
     switch (current_stepper) {
         case ST_I2S_STREAM:
@@ -313,11 +571,10 @@ static void stepper_pulse_func() {
             break;
         case ST_I2S_STATIC:
         case ST_TIMED:
-            // wait for step pulse time to complete...some time expired during code above
-            while (esp_timer_get_time() - step_pulse_start_time < pulse_microseconds->get()) {
-                NOP();  // spin here until time to turn off step
+            // End the pulse from the output scheduler...some time expired during code above
+            if (step_bits) {
+                st_output_at(step_time + st.pulse_ticks, st_step_off_event);
             }
-            motors_unstep();
             break;
         case ST_RMT:
             break;
@@ -334,6 +591,7 @@ void stepper_init() {
 #endif
     // Other stepper use timer interrupt
     Stepper_Timer_Init();
+    output_sched_init();
 }
 
 void stepper_switch(stepper_id_t new_stepper) {
@@ -359,8 +617,8 @@ void stepper_switch(stepper_id_t new_stepper) {
 void st_wake_up() {
     //grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "st_wake_up");
     // Enable stepper drivers.
-    motors_set_disable(false);
-    stepper_idle = false;
+    bool was_disabled = motors_set_disable(false);
+    stepper_idle      = false;
     // Initialize step pulse timing from settings. Here to ensure updating after re-writing.
 #ifdef STEP_PULSE_DELAY
     // Step pulse delay handling is not require with ESP32...the RMT function does it.
@@ -368,12 +626,31 @@ void st_wake_up() {
     // Set step pulse time. Ad hoc computation from oscilloscope. Uses two's complement.
     st.step_pulse_time = -(((pulse_microseconds->get() - 2) * ticksPerMicrosecond) >> 3);
 #endif
+    st.pulse_ticks     = pulse_microseconds->get() * ticksPerMicrosecond;
+    st.dir_setup_ticks = step_direction_delay->get() * ticksPerMicrosecond;
+    st.dir_setup_usecs = ceilf(step_direction_delay->get());
+
+    // The shaper can only change while the ISR is stopped
+    if (!st_running) {
+        shaper_init();
+    }
+
     // Enable Stepper Driver Interrupt
-    Stepper_Timer_Start();
+    if (was_disabled && step_enable_delay->get() > 0 && current_stepper != ST_I2S_STREAM) {
+        // Let the drivers wake up before the first step. The I2S stream does not
+        // need this; its first step is a full DMA queue behind the enable.
+        st_start_pending = true;
+        st_output_at(output_sched_now() + (uint64_t)step_enable_delay->get() * ticksPerMicrosecond, st_start_event);
+    } else {
+        st_start_pending = false;
+        Stepper_Timer_Start();
+    }
 }
 
 // Reset and clear stepper subsystem variables
 void st_reset() {
+    PlannerLock lock;
+
 #ifdef ESP_DEBUG
     //Serial.println("st_reset()");
 #endif
@@ -383,10 +660,20 @@ void st_reset() {
         i2s_out_reset();
     }
 #endif
+    // Stop the ISR, drop the pending output events and end any step pulse here, as a dropped
+    // step off event would leave the step pins high and the next step without a rising edge.
+    Stepper_Timer_Stop();
+    output_sched_reset();
+    motors_unstep();
     st_go_idle();
+    shaper_reset();
     // Initialize stepper algorithm variables.
     memset(&prep, 0, sizeof(st_prep_t));
     memset(&st, 0, sizeof(stepper_t));
+#ifdef CONSTANT_SURFACE_SPEED
+    prep.css_rpm = -1;
+    css_rpm      = -1;
+#endif
     st.exec_segment     = NULL;
     pl_block            = NULL;  // Planner block pointer used by segment buffer
     segment_buffer_tail = 0;
@@ -394,7 +681,8 @@ void st_reset() {
     segment_next_head   = 1;
     busy                = false;
     st.step_outbits     = 0;
-    st.dir_outbits      = 0;  // Initialize direction bits to default.
+    st.dir_outbits      = 0;     // Initialize direction bits to default.
+    st.dir_output       = 0xff;  // Unknown, so the first step gets the direction setup time
     // TODO do we need to turn step pins off?
 }
 
@@ -402,7 +690,8 @@ void st_reset() {
 void st_go_idle() {
     // Disable Stepper Driver Interrupt. Allow Stepper Port Reset Interrupt to finish, if active.
     Stepper_Timer_Stop();
-    busy = false;
+    st_start_pending = false;
+    busy             = false;
 
     // Set stepper driver idle state, disabled or enabled, depending on settings and circumstances.
     if (((stepper_idle_lock_time->get() != 0xff) || sys_rt_exec_alarm != ExecAlarm::None || sys.state == State::Sleep) &&
@@ -427,6 +716,8 @@ void st_go_idle() {
 
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters() {
+    PlannerLock lock;
+
     if (pl_block != NULL) {  // Ignore if at start of a new block.
         prep.recalculate_flag.recalculate = 1;
         pl_block->entry_speed_sqr         = prep.current_speed * prep.current_speed;  // Update entry speed.
@@ -437,6 +728,8 @@ void st_update_plan_block_parameters() {
 #ifdef PARKING_ENABLE
 // Changes the run state of the step segment buffer to execute the special parking motion.
 void st_parking_setup_buffer() {
+    PlannerLock lock;
+
     // Store step execution data of partially completed block, if necessary.
     if (prep.recalculate_flag.holdPartialBlock) {
         prep.last_st_block_index  = prep.st_block_index;
@@ -452,6 +745,8 @@ void st_parking_setup_buffer() {
 
 // Restores the step segment buffer to the normal run state after a parking motion.
 void st_parking_restore_buffer() {
+    PlannerLock lock;
+
     // Restore step execution data and flags of partially completed block, if necessary.
     if (prep.recalculate_flag.holdPartialBlock) {
         st_prep_block                          = &st_block_buffer[prep.last_st_block_index];
@@ -476,6 +771,193 @@ static uint8_t st_next_block_index(uint8_t block_index) {
     return block_index == (SEGMENT_BUFFER_SIZE - 1) ? 0 : block_index;
 }
 
+#ifdef NATIVE_ARCS
+// Signed steps of an axis over the whole planner block
+static int32_t st_block_travel(plan_block_t* block, uint8_t axis) {
+    return bit_istrue(block->direction_bits, bit(axis)) ? -int32_t(block->steps[axis]) : block->steps[axis];
+}
+
+// Sets up the segments of a new arc block. The segments need at least one step on an axis, so
+// step_per_mm is what the axis that moves the most has at the least, wherever it is on the arc.
+static void st_prep_arc_block() {
+    plan_arc_t& arc    = pl_block->arc;
+    float       radius = hypot_f(arc.radius[0], arc.radius[1]);
+    float       plane_mm_per_mm = fabsf(arc.angular_travel) * radius / arc.millimeters;
+    // Either plane axis moves at least 1/sqrt(2) of the plane distance
+    float plane_step_per_mm =
+        0.7071068f * MIN(axis_settings[arc.axis_0]->steps_per_mm->get(), axis_settings[arc.axis_1]->steps_per_mm->get());
+    float linear_step_per_mm = pl_block->steps[arc.axis_linear] / arc.millimeters;
+
+    prep.step_per_mm      = MAX(plane_mm_per_mm * plane_step_per_mm, linear_step_per_mm);
+    prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR / prep.step_per_mm;
+    prep.arc_chord_mm     = sqrtf(8 * radius * arc_tolerance->get()) / plane_mm_per_mm;
+    prep.arc_chords       = false;
+    prep.arc_angle        = 0.0;
+    memcpy(prep.arc_steps, arc.start_steps, sizeof(prep.arc_steps));
+}
+
+// The point on the arc at an angle from its start, on axis_0, axis_1 and axis_linear. The end of
+// the arc is the target of the block exactly.
+static void st_arc_point(float angle, int32_t* steps) {
+    plan_arc_t& arc     = pl_block->arc;
+    uint8_t     axes[3] = { arc.axis_0, arc.axis_1, arc.axis_linear };
+    if (angle == arc.angular_travel) {
+        for (int i = 0; i < 3; i++) {
+            steps[i] = arc.start_steps[i] + st_block_travel(pl_block, axes[i]);
+        }
+        return;
+    }
+    float sin_angle, cos_angle;
+    sincosf(angle, &sin_angle, &cos_angle);
+    float mm_0 = arc.center[0] + arc.radius[0] * cos_angle - arc.radius[1] * sin_angle;
+    float mm_1 = arc.center[1] + arc.radius[0] * sin_angle + arc.radius[1] * cos_angle;
+    steps[0]   = lroundf(mm_0 * axis_settings[axes[0]]->steps_per_mm->get());
+    steps[1]   = lroundf(mm_1 * axis_settings[axes[1]]->steps_per_mm->get());
+    steps[2]   = arc.start_steps[2] + lroundf(angle / arc.angular_travel * st_block_travel(pl_block, axes[2]));
+}
+
+// Sets a chord between two points of the arc as a Bresenham line. Returns the number of step events.
+static uint32_t st_arc_chord(st_chord_t* chord, int32_t* from, int32_t* to) {
+    plan_arc_t& arc     = pl_block->arc;
+    uint8_t     axes[3] = { arc.axis_0, arc.axis_1, arc.axis_linear };
+    memset(chord->steps, 0, sizeof(chord->steps));
+    chord->direction_bits = 0;
+    uint32_t events       = 0;
+    for (int i = 0; i < 3; i++) {
+        int32_t steps = to[i] - from[i];
+        if (steps < 0) {
+            chord->direction_bits |= bit(axes[i]);
+            steps = -steps;
+        }
+        chord->steps[axes[i]] = steps << maxAmassLevel;
+        events                = MAX(events, uint32_t(steps));
+    }
+    chord->step_event_count = events << maxAmassLevel;
+    return events;
+}
+
+// Prepares the stepper block for a segment of an arc block, from mm_start to mm_remaining from the
+// end of the block. The segment steps along as many chords within arc_tolerance of the arc as it
+// needs, up to ARC_SEGMENT_CHORDS. The angle along the arc is the state that is kept, and it only
+// moves forward, so a segment never steps back whatever distance a feed hold ends at. The first
+// segment uses the stepper block loaded with the planner block, the others each get the next one.
+// Returns the number of step events.
+static uint16_t st_prep_arc_segment(segment_t* segment, float mm_start, float mm_remaining) {
+    plan_arc_t& arc   = pl_block->arc;
+    float       angle = arc.angular_travel;
+    if (mm_remaining > 0.0f) {
+        angle = (1.0f - mm_remaining / arc.millimeters) * arc.angular_travel;
+        if (fabsf(angle) < fabsf(prep.arc_angle)) {
+            angle = prep.arc_angle;
+        }
+    }
+
+    uint8_t     index = prep.arc_chords ? st_next_block_index(prep.st_block_index) : prep.st_block_index;
+    st_block_t* block = &st_block_buffer[index];
+    if (prep.arc_chords) {
+        block->is_pwm_rate_adjusted = st_prep_block->is_pwm_rate_adjusted;
+#ifdef CONSTANT_SURFACE_SPEED
+        block->is_css = st_prep_block->is_css;
+#endif
+#ifdef LINE_TIMING
+        block->line_index    = st_prep_block->line_index;
+        block->line_number   = st_prep_block->line_number;
+        block->sequence      = st_prep_block->sequence;  // Counted with the first segment
+        block->programmed_us = st_prep_block->programmed_us;
+#endif
+    }
+    memset(block->steps, 0, sizeof(block->steps));
+    block->step_event_count = 0;
+    block->direction_bits   = 0;
+    block->n_chords         = 0;
+
+    // The first chord with steps is the line of the block, the ISR loads the others after it
+    int      n_chords = constrain(int(ceilf((mm_start - mm_remaining) / prep.arc_chord_mm)), 1, ARC_SEGMENT_CHORDS);
+    int32_t  from[3];
+    uint32_t events = 0;
+    memcpy(from, prep.arc_steps, sizeof(from));
+    for (int i = 1; i <= n_chords; i++) {
+        float to_angle = i == n_chords ? angle : prep.arc_angle + (angle - prep.arc_angle) * i / n_chords;
+        st_arc_point(to_angle, prep.arc_next);
+        st_chord_t chord;
+        uint32_t   chord_events = st_arc_chord(&chord, from, prep.arc_next);
+        if (chord_events == 0) {
+            continue;
+        }
+        if (events == 0) {
+            memcpy(block->steps, chord.steps, sizeof(block->steps));
+            block->step_event_count = chord.step_event_count;
+            block->direction_bits   = chord.direction_bits;
+        } else {
+            block->chords[block->n_chords++] = chord;
+        }
+        events += chord_events;
+        memcpy(from, prep.arc_next, sizeof(from));
+    }
+    prep.arc_next_angle     = angle;
+    segment->st_block_index = index;
+    return events;
+}
+#endif
+
+#ifdef CONSTANT_SURFACE_SPEED
+// G96 spindle speed, from the X radius where mm_remaining of the block is left
+static float st_css_rpm(float mm_remaining) {
+    float x = pl_block->css_x - pl_block->css_x_per_mm * mm_remaining;
+#ifdef NATIVE_ARCS
+    plan_arc_t& arc = pl_block->arc;
+    if (pl_block->motion.arc && (arc.axis_0 == X_AXIS || arc.axis_1 == X_AXIS)) {
+        float sin_angle, cos_angle;
+        sincosf((1.0f - mm_remaining / arc.millimeters) * arc.angular_travel, &sin_angle, &cos_angle);
+        if (arc.axis_0 == X_AXIS) {
+            x = arc.center[0] + arc.radius[0] * cos_angle - arc.radius[1] * sin_angle;
+        } else {
+            x = arc.center[1] + arc.radius[0] * sin_angle + arc.radius[1] * cos_angle;
+        }
+    }
+#endif
+    float radius = fabsf(x - pl_block->spindle_axis_x);
+    return MIN(pl_block->surface_speed / (2 * float(M_PI) * radius), pl_block->max_spindle_speed);
+}
+
+// Sends the G96 spindle speed of the running segment. A VFD spindle queues a Modbus command for it,
+// which cannot be done from the stepper ISR. A change within CSS_RPM_HYSTERESIS, or sooner than
+// CSS_MIN_INTERVAL after the last one, waits, unless the spindle speed has been set since by other
+// means, like the ISR for a segment without G96, a spindle override or the restore after a hold.
+static void st_css_send_rpm() {
+    int32_t rpm = css_rpm;
+    if (rpm < 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    if (prep.css_rpm >= 0 && prep.css_ovr == sys.spindle_speed_ovr && prep.css_spindle_speed == sys.spindle_speed) {
+        if (abs(rpm - prep.css_rpm) <= CSS_RPM_HYSTERESIS || now - prep.css_time < CSS_MIN_INTERVAL * 1000) {
+            return;
+        }
+    }
+    spindle->set_rpm(rpm);
+    prep.css_rpm           = rpm;
+    prep.css_ovr           = sys.spindle_speed_ovr;
+    prep.css_spindle_speed = sys.spindle_speed;
+    prep.css_time          = now;
+}
+#endif
+
+// Acceleration ticks of motion queued in the segment buffer behind the segment that is running. They
+// are what is left to run when that segment completes, so a long cruise segment does not use up the
+// time the buffer has to be refilled in.
+static uint8_t st_segment_buffer_ticks() {
+    uint8_t ticks = 0;
+    uint8_t index = segment_buffer_tail;
+    if (index == segment_buffer_head) {
+        return ticks;
+    }
+    for (index = (index + 1) % SEGMENT_BUFFER_SIZE; index != segment_buffer_head; index = (index + 1) % SEGMENT_BUFFER_SIZE) {
+        ticks += segment_buffer[index].ticks;
+    }
+    return ticks;
+}
+
 /* Prepares step segment buffer. Continuously called from main program.
 
    The segment buffer is an intermediary buffer interface between the execution of steps
@@ -490,12 +972,24 @@ static uint8_t st_next_block_index(uint8_t block_index) {
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
 void st_prep_buffer() {
+    PlannerLock lock;
+
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (sys.step_control.endMotion) {
         return;
     }
 
+#ifdef CONSTANT_SURFACE_SPEED
+    st_css_send_rpm();
+#endif
+
     while (segment_buffer_tail != segment_next_head) {  // Check if we need to fill the buffer.
+        // Long cruise segments fill the buffer by time before it is full of segments
+        uint8_t buffer_ticks = st_segment_buffer_ticks();
+        if (buffer_ticks >= SEGMENT_BUFFER_SIZE - 2) {
+            return;
+        }
+
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
         if (pl_block == NULL) {
             // Query planner for a queued block
@@ -509,6 +1003,9 @@ void st_prep_buffer() {
                 return;  // No planner blocks. Exit.
             }
 
+#ifdef PROFILE_TRACE
+            bool replanned = prep.recalculate_flag.recalculate;
+#endif
             // Check if we need to only recompute the velocity profile or load a new block.
             if (prep.recalculate_flag.recalculate) {
 #ifdef PARKING_ENABLE
@@ -538,6 +1035,19 @@ void st_prep_buffer() {
                     st_prep_block->steps[idx] = pl_block->steps[idx] << maxAmassLevel;
                 }
                 st_prep_block->step_event_count = pl_block->step_event_count << maxAmassLevel;
+#ifdef CONSTANT_SURFACE_SPEED
+                st_prep_block->is_css = pl_block->surface_speed > 0.0f;
+#endif
+#ifdef NATIVE_ARCS
+                st_prep_block->n_chords = 0;
+#endif
+#ifdef LINE_TIMING
+                st_prep_block->line_index    = pl_block->line_index;
+                st_prep_block->line_number   = pl_block->line_number;
+                st_prep_block->sequence      = pl_block->sequence;
+                st_prep_block->programmed_us =
+                    pl_block->programmed_rate > 0.0f ? pl_block->millimeters / pl_block->programmed_rate * 60e6f : 0;
+#endif
 
                 // Initialize segment buffer data for generating the segments.
                 prep.steps_remaining  = (float)pl_block->step_event_count;
@@ -550,13 +1060,24 @@ void st_prep_buffer() {
                     pl_block->entry_speed_sqr           = prep.exit_speed * prep.exit_speed;
                     prep.recalculate_flag.decelOverride = 0;
                 } else {
-                    prep.current_speed = sqrt(pl_block->entry_speed_sqr);
+                    prep.current_speed = sqrtf(pl_block->entry_speed_sqr);
+                }
+
+                if (pl_block->motion.spindleSync) {
+                    prep.sync_mm_total = pl_block->millimeters;
+                    prep.sync_time     = esp_timer_get_time();
+                    prep.current_speed = 0.0;  // From a stop, see mc_spindle_sync_line()
                 }
+#ifdef NATIVE_ARCS
+                if (pl_block->motion.arc) {
+                    st_prep_arc_block();
+                }
+#endif
 
                 if (spindle->isRateAdjusted()) {  //   laser_mode->get() {
                     if (pl_block->spindle == SpindleState::Ccw) {
                         // Pre-compute inverse programmed rate to speed up PWM updating per step segment.
-                        prep.inv_rate                       = 1.0 / pl_block->programmed_rate;
+                        prep.inv_rate                       = 1.0f / pl_block->programmed_rate;
                         st_prep_block->is_pwm_rate_adjusted = true;
                     }
                 }
@@ -568,16 +1089,16 @@ void st_prep_buffer() {
              hold, override the planner velocities and decelerate to the target exit speed.
             */
             prep.mm_complete  = 0.0;  // Default velocity profile complete at 0.0mm from end of block.
-            float inv_2_accel = 0.5 / pl_block->acceleration;
+            float inv_2_accel = 0.5f / pl_block->acceleration;
             if (sys.step_control.executeHold) {  // [Forced Deceleration to Zero Velocity]
                 // Compute velocity profile parameters for a feed hold in-progress. This profile overrides
                 // the planner block profile, enforcing a deceleration to zero speed.
                 prep.ramp_type = RAMP_DECEL;
                 // Compute decelerate distance relative to end of block.
                 float decel_dist = pl_block->millimeters - inv_2_accel * pl_block->entry_speed_sqr;
-                if (decel_dist < 0.0) {
+                if (decel_dist < 0.0f) {
                     // Deceleration through entire planner block. End of feed hold is not in this block.
-                    prep.exit_speed = sqrt(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
+                    prep.exit_speed = sqrtf(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
                 } else {
                     prep.mm_complete = decel_dist;  // End of feed hold.
                     prep.exit_speed  = 0.0;
@@ -592,20 +1113,20 @@ void st_prep_buffer() {
                     prep.exit_speed = exit_speed_sqr = 0.0;  // Enforce stop at end of system motion.
                 } else {
                     exit_speed_sqr  = plan_get_exec_block_exit_speed_sqr();
-                    prep.exit_speed = sqrt(exit_speed_sqr);
+                    prep.exit_speed = sqrtf(exit_speed_sqr);
                 }
 
                 nominal_speed            = plan_compute_profile_nominal_speed(pl_block);
                 float nominal_speed_sqr  = nominal_speed * nominal_speed;
-                float intersect_distance = 0.5 * (pl_block->millimeters + inv_2_accel * (pl_block->entry_speed_sqr - exit_speed_sqr));
+                float intersect_distance = 0.5f * (pl_block->millimeters + inv_2_accel * (pl_block->entry_speed_sqr - exit_speed_sqr));
                 if (pl_block->entry_speed_sqr > nominal_speed_sqr) {  // Only occurs during override reductions.
                     prep.accelerate_until = pl_block->millimeters - inv_2_accel * (pl_block->entry_speed_sqr - nominal_speed_sqr);
-                    if (prep.accelerate_until <= 0.0) {  // Deceleration-only.
+                    if (prep.accelerate_until <= 0.0f) {  // Deceleration-only.
                         prep.ramp_type = RAMP_DECEL;
                         // prep.decelerate_after = pl_block->millimeters;
                         // prep.maximum_speed = prep.current_speed;
                         // Compute override block exit speed since it doesn't match the planner exit speed.
-                        prep.exit_speed = sqrt(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
+                        prep.exit_speed = sqrtf(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
                         prep.recalculate_flag.decelOverride = 1;  // Flag to load next block as deceleration override.
                         // TODO: Determine correct handling of parameters in deceleration-only.
                         // Can be tricky since entry speed will be current speed, as in feed holds.
@@ -616,7 +1137,7 @@ void st_prep_buffer() {
                         prep.maximum_speed    = nominal_speed;
                         prep.ramp_type        = RAMP_DECEL_OVERRIDE;
                     }
-                } else if (intersect_distance > 0.0) {
+                } else if (intersect_distance > 0.0f) {
                     if (intersect_distance < pl_block->millimeters) {  // Either trapezoid or triangle types
                         // NOTE: For acceleration-cruise and cruise-only types, following calculation will be 0.0.
                         prep.decelerate_after = inv_2_accel * (nominal_speed_sqr - exit_speed_sqr);
@@ -632,7 +1153,7 @@ void st_prep_buffer() {
                         } else {  // Triangle type
                             prep.accelerate_until = intersect_distance;
                             prep.decelerate_after = intersect_distance;
-                            prep.maximum_speed    = sqrt(2.0 * pl_block->acceleration * intersect_distance + exit_speed_sqr);
+                            prep.maximum_speed    = sqrtf(2.0f * pl_block->acceleration * intersect_distance + exit_speed_sqr);
                         }
                     } else {  // Deceleration-only type
                         prep.ramp_type = RAMP_DECEL;
@@ -646,7 +1167,16 @@ void st_prep_buffer() {
                 }
             }
 
+            if (pl_block->motion.spindleSync) {
+                // The spindle sets the pace instead of the velocity profile. A feed hold waits for the end of the block.
+                prep.ramp_type   = RAMP_SYNC;
+                prep.mm_complete = 0.0;
+            }
+
             sys.step_control.updateSpindleRpm = true;  // Force update whenever updating block.
+#ifdef PROFILE_TRACE
+            profile_trace_block(pl_block, replanned, prep.current_speed, prep.exit_speed);
+#endif
         }
 
         // Initialize new segment
@@ -669,7 +1199,12 @@ void st_prep_buffer() {
           the end of planner block (typical) or mid-block at the end of a forced deceleration,
           such as from a feed hold.
         */
-        float dt_max   = DT_SEGMENT;                                // Maximum segment time
+        // A segment that starts cruising may be longer, to as much time as is left behind the running segment
+        prep_segment->ticks = 1;
+        if (prep.ramp_type == RAMP_CRUISE && !pl_block->motion.spindleSync && !pl_block->motion.arc) {
+            prep_segment->ticks = MIN(CRUISE_SEGMENT_TICKS, SEGMENT_BUFFER_SIZE - 2 - buffer_ticks);
+        }
+        float dt_max   = DT_SEGMENT * prep_segment->ticks;          // Maximum segment time
         float dt       = 0.0;                                       // Initialize segment time
         float time_var = dt_max;                                    // Time worker variable
         float mm_var;                                               // mm-Distance worker variable
@@ -677,20 +1212,25 @@ void st_prep_buffer() {
         float mm_remaining = pl_block->millimeters;                 // New segment distance from end of block.
         float minimum_mm   = mm_remaining - prep.req_mm_increment;  // Guarantee at least one step.
 
-        if (minimum_mm < 0.0) {
+        if (minimum_mm < 0.0f) {
             minimum_mm = 0.0;
         }
 
+        int64_t sync_start = 0;  // When the segment starts, for spindle synchronized motion (usec)
+        if (pl_block->motion.spindleSync) {
+            minimum_mm = mm_remaining;  // Segments without steps are queued while the spindle is short of a step
+        }
+
         do {
             switch (prep.ramp_type) {
                 case RAMP_DECEL_OVERRIDE:
                     speed_var = pl_block->acceleration * time_var;
-                    mm_var    = time_var * (prep.current_speed - 0.5 * speed_var);
+                    mm_var    = time_var * (prep.current_speed - 0.5f * speed_var);
                     mm_remaining -= mm_var;
                     if ((mm_remaining < prep.accelerate_until) || (mm_var <= 0)) {
                         // Cruise or cruise-deceleration types only for deceleration override.
                         mm_remaining       = prep.accelerate_until;  // NOTE: 0.0 at EOB
-                        time_var           = 2.0 * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
+                        time_var           = 2.0f * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
                         prep.ramp_type     = RAMP_CRUISE;
                         prep.current_speed = prep.maximum_speed;
                     } else {  // Mid-deceleration override ramp.
@@ -700,11 +1240,11 @@ void st_prep_buffer() {
                 case RAMP_ACCEL:
                     // NOTE: Acceleration ramp only computes during first do-while loop.
                     speed_var = pl_block->acceleration * time_var;
-                    mm_remaining -= time_var * (prep.current_speed + 0.5 * speed_var);
+                    mm_remaining -= time_var * (prep.current_speed + 0.5f * speed_var);
                     if (mm_remaining < prep.accelerate_until) {  // End of acceleration ramp.
                         // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
                         mm_remaining = prep.accelerate_until;  // NOTE: 0.0 at EOB
-                        time_var     = 2.0 * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
+                        time_var     = 2.0f * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
                         if (mm_remaining == prep.decelerate_after) {
                             prep.ramp_type = RAMP_DECEL;
                         } else {
@@ -725,24 +1265,50 @@ void st_prep_buffer() {
                         time_var       = (mm_remaining - prep.decelerate_after) / prep.maximum_speed;
                         mm_remaining   = prep.decelerate_after;  // NOTE: 0.0 at EOB
                         prep.ramp_type = RAMP_DECEL;
+                        dt_max         = DT_SEGMENT;  // A long cruise segment ends here, or fills one tick with deceleration
                     } else {  // Cruising only.
                         mm_remaining = mm_var;
                     }
                     break;
+#ifdef SPINDLE_SYNC
+                case RAMP_SYNC: {
+                    // The distance follows the spindle, to where it is predicted to be at the end of this
+                    // segment, within the acceleration of the block. Lag is caught up as fast as the
+                    // acceleration allows without overshooting, and the block still ends at rest.
+                    int64_t now    = esp_timer_get_time();
+                    sync_start     = MAX(prep.sync_time, now);
+                    float rpm      = spindle_encoder_rpm();
+                    float ahead    = rpm * ((sync_start - now) / 60e6f + time_var);  // Revolutions to the end of the segment
+                    float revs     = spindle_encoder_revs(pl_block->sync_count, spindle_encoder_count()) + ahead;  // Since the block start
+                    float turned   = pl_block->spindle == SpindleState::Ccw ? -revs : revs;
+                    float lag      = mm_remaining - (prep.sync_mm_total - turned * pl_block->sync_pitch);  // (mm)
+                    float catch_up = sqrtf(2.0f * pl_block->acceleration * fabsf(lag));
+                    float dv       = pl_block->acceleration * time_var;  // Speed change within the segment
+                    speed_var      = fabsf(rpm) * pl_block->sync_pitch + (lag > 0.0f ? catch_up : -catch_up);
+                    speed_var      = MIN(speed_var, sqrtf(2.0f * pl_block->acceleration * mm_remaining));
+                    speed_var      = constrain(speed_var, prep.current_speed - dv, prep.current_speed + dv);
+                    speed_var      = constrain(speed_var, 0.0f, pl_block->rapid_rate);
+                    mm_remaining -= time_var * 0.5f * (prep.current_speed + speed_var);
+                    if (mm_remaining < 0.0f) {
+                        mm_remaining = 0.0;
+                    }
+                    prep.current_speed = speed_var;
+                } break;
+#endif
                 default:  // case RAMP_DECEL:
                     // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
                     speed_var = pl_block->acceleration * time_var;  // Used as delta speed (mm/min)
                     if (prep.current_speed > speed_var) {           // Check if at or below zero speed.
                         // Compute distance from end of segment to end of block.
-                        mm_var = mm_remaining - time_var * (prep.current_speed - 0.5 * speed_var);  // (mm)
-                        if (mm_var > prep.mm_complete) {                                            // Typical case. In deceleration ramp.
+                        mm_var = mm_remaining - time_var * (prep.current_speed - 0.5f * speed_var);  // (mm)
+                        if (mm_var > prep.mm_complete) {                                             // Typical case. In deceleration ramp.
                             mm_remaining = mm_var;
                             prep.current_speed -= speed_var;
                             break;  // Segment complete. Exit switch-case statement. Continue do-while loop.
                         }
                     }
                     // Otherwise, at end of block or end of forced-deceleration.
-                    time_var           = 2.0 * (mm_remaining - prep.mm_complete) / (prep.current_speed + prep.exit_speed);
+                    time_var           = 2.0f * (mm_remaining - prep.mm_complete) / (prep.current_speed + prep.exit_speed);
                     mm_remaining       = prep.mm_complete;
                     prep.current_speed = prep.exit_speed;
             }
@@ -765,9 +1331,18 @@ void st_prep_buffer() {
         /* -----------------------------------------------------------------------------------
           Compute spindle speed PWM output for step segment
         */
-        if (st_prep_block->is_pwm_rate_adjusted || sys.step_control.updateSpindleRpm) {
+        bool update_rpm = st_prep_block->is_pwm_rate_adjusted || sys.step_control.updateSpindleRpm;
+#ifdef CONSTANT_SURFACE_SPEED
+        update_rpm = update_rpm || st_prep_block->is_css;  // G96 changes it in every segment
+#endif
+        if (update_rpm) {
             if (pl_block->spindle != SpindleState::Disable) {
                 float rpm = pl_block->spindle_speed;
+#ifdef CONSTANT_SURFACE_SPEED
+                if (st_prep_block->is_css) {
+                    rpm = st_css_rpm(mm_remaining);  // G96, at the X radius the segment ends at
+                }
+#endif
                 // NOTE: Feed and rapid overrides are independent of PWM value and do not alter laser power/rate.
                 if (st_prep_block->is_pwm_rate_adjusted) {
                     rpm *= (prep.current_speed * prep.inv_rate);
@@ -797,9 +1372,30 @@ void st_prep_buffer() {
            supported by Grbl (i.e. exceeding 10 meters axis travel at 200 step/mm).
         */
         float step_dist_remaining    = prep.step_per_mm * mm_remaining;             // Convert mm_remaining to steps
-        float n_steps_remaining      = ceil(step_dist_remaining);                   // Round-up current steps remaining
-        float last_n_steps_remaining = ceil(prep.steps_remaining);                  // Round-up last steps remaining
+        float n_steps_remaining      = ceilf(step_dist_remaining);                  // Round-up current steps remaining
+        float last_n_steps_remaining = ceilf(prep.steps_remaining);                 // Round-up last steps remaining
         prep_segment->n_step         = last_n_steps_remaining - n_steps_remaining;  // Compute number of steps to execute.
+#ifdef NATIVE_ARCS
+        if (pl_block->motion.arc) {
+            prep_segment->n_step = st_prep_arc_segment(prep_segment, pl_block->millimeters, mm_remaining);
+        }
+#endif
+
+        if (pl_block->motion.spindleSync) {
+            if (prep_segment->n_step == 0) {
+                // The spindle has not turned far enough for a step. Queue a segment
+                // without steps, so the stepper keeps running while it waits.
+                prep_segment->amass_level = 0;
+                prep_segment->isrPeriod   = 0xffff;
+                prep.sync_time            = sync_start + 0xffff / ticksPerMicrosecond;
+                segment_buffer_head       = segment_next_head;
+                if (++segment_next_head == SEGMENT_BUFFER_SIZE) {
+                    segment_next_head = 0;
+                }
+                continue;
+            }
+            prep.sync_time = sync_start + int64_t(DT_SEGMENT * 60e6f);
+        }
 
         // Bail if we are at the end of a feed hold and don't have a step to execute.
         if (prep_segment->n_step == 0) {
@@ -828,11 +1424,16 @@ void st_prep_buffer() {
         dt += prep.dt_remainder;                                               // Apply previous segment partial step execute time
         // dt is in minutes so inv_rate is in minutes
         float inv_rate = dt / (last_n_steps_remaining - step_dist_remaining);  // Compute adjusted step rate inverse
+#ifdef NATIVE_ARCS
+        if (pl_block->motion.arc) {
+            inv_rate = dt / MAX(prep_segment->n_step, 1);  // The chords have whole steps at both ends
+        }
+#endif
 
         // Compute CPU cycles per step for the prepped segment.
         // fStepperTimer is in units of timerTicks/sec, so the dimensional analysis is
         // timerTicks/sec * 60 sec/minute * minutes = timerTicks
-        uint32_t timerTicks = ceil((fStepperTimer * 60) * inv_rate);  // (timerTicks/step)
+        uint32_t timerTicks = ceilf((fStepperTimer * 60) * inv_rate);  // (timerTicks/step)
         int level;
 
         // Compute step timing and multi-axis smoothing level.
@@ -847,6 +1448,9 @@ void st_prep_buffer() {
         // isrPeriod is stored as 16 bits, so limit timerTicks to the
         // largest value that will fit in a uint16_t.
         prep_segment->isrPeriod = timerTicks > 0xffff ? 0xffff : timerTicks;
+#ifdef PROFILE_TRACE
+        profile_trace_segment(dt, prep.current_speed, prep_segment->n_step >> level);
+#endif
 
         // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
         segment_buffer_head = segment_next_head;
@@ -857,10 +1461,21 @@ void st_prep_buffer() {
         pl_block->millimeters = mm_remaining;
         prep.steps_remaining  = n_steps_remaining;
         prep.dt_remainder     = (n_steps_remaining - step_dist_remaining) * inv_rate;
+#ifdef NATIVE_ARCS
+        if (pl_block->motion.arc) {
+            // The next segment starts where this one ends
+            prep.st_block_index = prep_segment->st_block_index;
+            st_prep_block       = &st_block_buffer[prep.st_block_index];
+            prep.arc_chords     = true;
+            prep.arc_angle      = prep.arc_next_angle;
+            prep.dt_remainder   = 0.0;
+            memcpy(prep.arc_steps, prep.arc_next, sizeof(prep.arc_steps));
+        }
+#endif
         // Check for exit conditions and flag to load next planner block.
         if (mm_remaining == prep.mm_complete) {
             // End of planner block or forced-termination. No more distance to be executed.
-            if (mm_remaining > 0.0) {  // At end of forced-termination.
+            if (mm_remaining > 0.0f) {  // At end of forced-termination.
                 // Reset prep parameters for resuming and then bail. Allow the stepper ISR to complete
                 // the segment queue, where realtime protocol will set new state upon receiving the
                 // cycle stop flag from the ISR. Prep_segment is blocked until then.
@@ -901,6 +1516,18 @@ float st_get_realtime_rate() {
     }
 }
 
+void st_report_buffer_sizes(uint8_t client) {
+    grbl_msg_sendf(client,
+                   MsgLevel::Info,
+                   "Buffers planner %d x %u, stepper %d x %u, segments %d x %u bytes",
+                   BLOCK_BUFFER_SIZE,
+                   sizeof(plan_block_t),
+                   SEGMENT_BUFFER_SIZE - 1,
+                   sizeof(st_block_t),
+                   SEGMENT_BUFFER_SIZE,
+                   sizeof(segment_t));
+}
+
 // The argument is in units of ticks of the timer that generates ISRs
 void IRAM_ATTR Stepper_Timer_WritePeriod(uint16_t timerTicks) {
     if (current_stepper == ST_I2S_STREAM) {
@@ -933,6 +1560,7 @@ void IRAM_ATTR Stepper_Timer_Start() {
 #ifdef ESP_DEBUG
     //Serial.println("ST Start");
 #endif
+    st_running = true;
     if (current_stepper == ST_I2S_STREAM) {
 #ifdef USE_I2S_STEPS
         i2s_out_set_stepping();
@@ -948,6 +1576,7 @@ void IRAM_ATTR Stepper_Timer_Stop() {
 #ifdef ESP_DEBUG
     //Serial.println("ST Stop");
 #endif
+    st_running = false;
     if (current_stepper == ST_I2S_STREAM) {
 #ifdef USE_I2S_STEPS
         i2s_out_set_passthrough();
@@ -32,12 +32,13 @@
 #include "Config.h"
 
 // Some useful constants.
-const double DT_SEGMENT              = (1.0 / (ACCELERATION_TICKS_PER_SECOND * 60.0));  // min/segment
-const double REQ_MM_INCREMENT_SCALAR = 1.25;
-const int    RAMP_ACCEL              = 0;
-const int    RAMP_CRUISE             = 1;
-const int    RAMP_DECEL              = 2;
-const int    RAMP_DECEL_OVERRIDE     = 3;
+const float DT_SEGMENT              = (1.0f / (ACCELERATION_TICKS_PER_SECOND * 60.0f));  // min/segment
+const float REQ_MM_INCREMENT_SCALAR = 1.25f;
+const int   RAMP_ACCEL              = 0;
+const int   RAMP_CRUISE             = 1;
+const int   RAMP_DECEL              = 2;
+const int   RAMP_DECEL_OVERRIDE     = 3;
+const int   RAMP_SYNC               = 4;  // Spindle synchronized motion
 
 struct PrepFlag {
     uint8_t recalculate : 1;
@@ -124,6 +125,9 @@ void st_update_plan_block_parameters();
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+// Report the sizes of the planner, stepper block and segment buffers, for $I
+void st_report_buffer_sizes(uint8_t client);
+
 // disable (or enable) steppers via STEPPERS_DISABLE_PIN
 bool get_stepper_disable();  // returns the state of the pin
 
@@ -239,6 +239,9 @@ ControlPins system_control_get_state() {
 #endif
 #ifdef INVERT_CONTROL_PIN_MASK
     pin_states.value ^= (INVERT_CONTROL_PIN_MASK & defined_pins.value);
+#endif
+#ifdef SIMULATED_INPUTS
+    pin_states.value |= sim_inputs_control().value;
 #endif
     return pin_states;
 }
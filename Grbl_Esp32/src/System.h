@@ -38,12 +38,13 @@ enum class State : uint8_t {
     Sleep,       // Sleep state.
 };
 
-// Step segment generator state flags.
+// Step segment generator state flags. With PLANNER_TASK the segment generator writes them on the
+// other core, so each flag is a byte of its own, and a write does not rewrite the others.
 struct StepControl {
-    uint8_t endMotion : 1;
-    uint8_t executeHold : 1;
-    uint8_t executeSysMotion : 1;
-    uint8_t updateSpindleRpm : 1;
+    bool endMotion;
+    bool executeHold;
+    bool executeSysMotion;
+    bool updateSpindleRpm;
 };
 
 // System suspend flags. Used in various ways to manage suspend states and procedures.
@@ -98,6 +99,7 @@ typedef struct {
     bool           probe_succeeded;     // Tracks if last probing cycle was successful.
     AxisMask       homing_axis_lock;    // Locks axes when limits engage. Used as an axis motion mask in the stepper ISR.
     Percent        f_override;          // Feed rate override value in percent
+    Percent        f_adaptive;          // Feed rate scaling from the spindle load in percent
     Percent        r_override;          // Rapids override value in percent
     Percent        spindle_speed_ovr;   // Spindle speed value in percent
     SpindleStop    spindle_stop_ovr;    // Tracks spindle stop override states
@@ -846,6 +846,23 @@ namespace WebUI {
         return Error::Ok;
     }
 
+#ifdef PROFILE_TRACE
+    static Error showProfileTrace(char* parameter, AuthenticationLevel auth_level) {  // ESP290
+        parameter = trim(parameter);
+        if (strcasecmp(parameter, "CLEAR") == 0) {
+            profile_trace_clear();
+            return Error::Ok;
+        }
+        if (*parameter != '\0' && strcasecmp(parameter, "JSON") != 0) {
+            return Error::InvalidValue;
+        }
+        if (espresponse) {
+            profile_trace_report(espresponse, *parameter != '\0');
+        }
+        return Error::Ok;
+    }
+#endif
+
     static Error showSDStatus(char* parameter, AuthenticationLevel auth_level) {  // ESP200
         const char* resp = "No SD card";
 #ifdef ENABLE_SD_CARD
@@ -1043,6 +1060,9 @@ namespace WebUI {
         new WebCommand("P=position T=type V=value", WEBCMD, WA, "ESP401", "WebUI/Set", setWebSetting);
         new WebCommand(NULL, WEBCMD, WU, "ESP400", "WebUI/List", listSettings);
 #endif
+#ifdef PROFILE_TRACE
+        new WebCommand("JSON|CLEAR", WEBCMD, WU, "ESP290", "Trace/Profile", showProfileTrace);
+#endif
 #ifdef ENABLE_SD_CARD
         new WebCommand("path", WEBCMD, WU, "ESP221", "SD/Show", showSDFile);
         new WebCommand("path", WEBCMD, WU, "ESP220", "SD/Run", runSDFile);
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""\
+Share the serial port of a controller with g-code senders over TCP or a
+pty, and measure how they stream.
+
+    bridge.py /dev/ttyUSB0 --port 2323         senders connect to localhost:2323
+    bridge.py /dev/ttyUSB0 --pty /tmp/grbl     senders open /tmp/grbl
+
+Everything a sender writes goes to the controller, and everything the
+controller writes goes to every sender. On the way through, the lines
+of the senders are matched with the ok and error responses, so the
+bridge can report:
+
+  - lines and bytes per second
+  - ok latency, from the end of a line to its response
+  - the bytes in the serial buffer of the controller. A character
+    counting sender should never have more than --rx-buffer of them
+    there. If it does, the line is counted as an overrun.
+
+Realtime characters (?, !, ~, ctrl-x and the override codes) are
+passed on but not counted as lines. Ctrl-x forgets the lines in the
+buffer. The statistics are printed every --stats seconds and at the
+end (ctrl-c).
+
+With ENABLE_TELNET the controller itself accepts TCP connections. The
+bridge also works for USB-only boards, and it can measure any sender.
+
+Requires pySerial.
+"""
+
+import argparse
+import os
+import select
+import socket
+import sys
+import time
+import tty
+
+import serial
+
+RX_BUFFER_SIZE = 128
+BAUD_RATE = 115200
+
+REALTIME = b'?!~\x18'
+
+
+class Stats:
+    def __init__(self, rx_buffer):
+        self.rx_buffer = rx_buffer
+        self.in_flight = []  # [length, time the line was complete] of the lines without a response
+        self.partial = 0  # Bytes of the line the senders are writing
+        self.lines = 0
+        self.bytes = 0
+        self.errors = 0
+        self.overruns = 0
+        self.max_in_flight = 0
+        self.latencies = []
+        self.start = time.time()
+
+    def from_sender(self, data, now):
+        for c in data:
+            if c in REALTIME or c >= 0x80:
+                if c == 0x18:
+                    self.in_flight = []
+                    self.partial = 0
+                continue
+            self.partial += 1
+            self.bytes += 1
+            if c == ord('\n'):
+                self.in_flight.append([self.partial, now])
+                self.partial = 0
+                used = sum(n for n, _ in self.in_flight)
+                self.max_in_flight = max(self.max_in_flight, used)
+                if used > self.rx_buffer:
+                    self.overruns += 1
+
+    def from_controller(self, line, now):
+        if line != 'ok' and not line.startswith('error'):
+            return
+        if line.startswith('error'):
+            self.errors += 1
+        if self.in_flight:
+            _, sent = self.in_flight.pop(0)
+            self.latencies.append(now - sent)
+            self.lines += 1
+
+    def report(self):
+        elapsed = max(time.time() - self.start, 1e-6)
+        text = '%d lines %.1f lines/s %.0f bytes/s, %d errors, max %d bytes in flight, %d overruns' % (
+            self.lines, self.lines / elapsed, self.bytes / elapsed, self.errors, self.max_in_flight, self.overruns)
+        if self.latencies:
+            latencies = sorted(self.latencies)
+            n = len(latencies)
+            text += ', ok latency mean %.1fms p50 %.1fms p99 %.1fms max %.1fms' % (
+                1000 * sum(latencies) / n, 1000 * latencies[n // 2], 1000 * latencies[min(n - 1, n * 99 // 100)],
+                1000 * latencies[-1])
+        print(text)
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Share a controller with g-code senders over TCP or a pty.')
+    parser.add_argument('device_file', help='serial device path')
+    parser.add_argument('--baud', type=int, default=BAUD_RATE)
+    parser.add_argument('--port', type=int, help='TCP port to listen on')
+    parser.add_argument('--host', default='127.0.0.1', help='address to listen on')
+    parser.add_argument('--pty', help='path of a link to a pty that senders can open')
+    parser.add_argument('--rx-buffer', type=int, default=RX_BUFFER_SIZE, help='serial buffer of the controller')
+    parser.add_argument('--stats', type=float, default=10.0, help='seconds between statistics, 0 for none')
+    args = parser.parse_args()
+    if args.port is None and args.pty is None:
+        parser.error('give --port, --pty or both')
+
+    s = serial.Serial(args.device_file, args.baud, timeout=0)
+    stats = Stats(args.rx_buffer)
+    senders = []  # Sockets and the pty master
+    listener = None
+    if args.port is not None:
+        listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listener.bind((args.host, args.port))
+        listener.listen(4)
+        print('listening on %s:%d' % (args.host, args.port))
+    pty_master = None
+    if args.pty:
+        pty_master, pty_slave = os.openpty()  # The slave stays open, so a sender may close and reopen it
+        tty.setraw(pty_slave)
+        if os.path.lexists(args.pty):
+            os.remove(args.pty)
+        os.symlink(os.ttyname(pty_slave), args.pty)
+        senders.append(pty_master)
+        print('%s is %s' % (args.pty, os.ttyname(pty_slave)))
+
+    def send(fd, data):
+        try:
+            if isinstance(fd, socket.socket):
+                fd.sendall(data)
+            else:
+                os.write(fd, data)
+        except OSError:
+            if fd in senders and fd is not pty_master:
+                senders.remove(fd)
+                fd.close()
+
+    received = b''
+    next_stats = time.time() + args.stats
+    try:
+        while True:
+            inputs = [s] + senders + ([listener] if listener else [])
+            ready, _, _ = select.select(inputs, [], [], 0.1)
+            now = time.time()
+            for fd in ready:
+                if fd is listener:
+                    conn, addr = listener.accept()
+                    conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                    senders.append(conn)
+                    print('sender %s:%d connected' % addr)
+                elif fd is s:
+                    data = s.read(s.in_waiting or 1)
+                    for sender in list(senders):
+                        send(sender, data)
+                    received += data
+                    while b'\n' in received:
+                        line, received = received.split(b'\n', 1)
+                        stats.from_controller(line.decode(errors='replace').strip(), now)
+                else:
+                    data = fd.recv(4096) if isinstance(fd, socket.socket) else os.read(fd, 4096)
+                    if not data:
+                        senders.remove(fd)
+                        if isinstance(fd, socket.socket):
+                            fd.close()
+                        else:
+                            os.close(fd)  # The pty master is a file descriptor
+                        print('sender disconnected')
+                        continue
+                    stats.from_sender(data, now)
+                    s.write(data)
+            if args.stats and now >= next_stats:
+                stats.report()
+                next_stats = now + args.stats
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stats.report()
+        if args.pty and os.path.islink(args.pty):
+            os.remove(args.pty)
+        s.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""\
+Fuzz the g-code parser and the $ commands of a controller.
+
+Lines are made by mutating the lines of the test files: characters are
+flipped, dropped or repeated, words are added with values that are
+known to be awkward (huge, tiny, negative, many digits, no digits), and
+lines are spliced together. Each line goes through gc_execute_line or
+system_execute_line, with the controller in check mode ($C), so nothing
+moves.
+
+A line must be answered by ok, error:N or an ALARM within --timeout
+seconds. The controller is reset after an alarm, as it locks up. A
+reboot (the Grbl banner or an ESP32 panic), no answer or any other
+answer counts as a failure, and the lines sent since the last reset are
+saved to --crashes so the failure can be replayed with stream.py.
+
+With --reference, every line is also sent to a second controller with a
+reference build, and the answers must be the same. That way a faster
+parser can be checked against the one it replaces.
+
+$ lines that would write settings, format the file system or restart
+the controller are not sent, unless --settings is given. They wear the
+flash and do not test the parser.
+
+Requires pySerial.
+"""
+
+import argparse
+import glob
+import os
+import random
+import sys
+import time
+
+import serial
+
+BAUD_RATE = 115200
+
+WORD_LETTERS = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+AWKWARD_VALUES = [
+    '0', '-0', '1', '-1', '0.0001', '-0.0001', '.', '-', '+', '1.', '.5', '1e3', '3.40282e38', '-3.40282e38',
+    '99999999999999999999', '0.00000000000000000001', '255', '256', '65535', '65536', '2147483648', '-2147483649',
+    '1.2.3', '--1', '10.1', '28.1', '38.2', '43.1', '54.1', '92.1',
+]
+SYSTEM_LINES = ['$', '$$', '$#', '$G', '$I', '$N', '$C', '$X', '$S', '$L', '$CMD', '$E', '$+', '$J=', '$Encoder/Slip']
+UNSAFE_PREFIXES = ['$RST', '$FORMAT', '$BYE', '$REBOOT', '$H', '$SLP', '$N0=', '$N1=', '$WIFI', '$BT', '$SD/']
+
+
+def load_seeds(tests):
+    """Lines of each test file. A file is picked first, so the long ones do not drown the others."""
+    seeds = [SYSTEM_LINES]
+    for path in sorted(glob.glob(os.path.join(tests, '**', '*.nc'), recursive=True)):
+        lines = set()
+        with open(path, errors='replace') as f:
+            for line in f:
+                line = line.strip()
+                if line and not line.startswith(';') and len(line) < 80:
+                    lines.add(line)
+        if lines:
+            seeds.append(sorted(lines))
+    return seeds
+
+
+def mutate(rng, seeds):
+    line = rng.choice(rng.choice(seeds))
+    for _ in range(rng.randint(1, 4)):
+        op = rng.randrange(6)
+        pos = rng.randint(0, len(line))
+        if op == 0:  # Add a word
+            word = rng.choice(WORD_LETTERS) + rng.choice(AWKWARD_VALUES)
+            line = line[:pos] + word + line[pos:]
+        elif op == 1 and line:  # Drop characters
+            line = line[:pos] + line[pos + rng.randint(1, 3):]
+        elif op == 2 and line:  # Repeat a part
+            end = rng.randint(pos, len(line))
+            line = line[:end] + line[pos:end] * rng.randint(1, 8) + line[end:]
+        elif op == 3:  # Splice with another line
+            other = rng.choice(rng.choice(seeds))
+            line = line[:pos] + other[rng.randint(0, len(other)):]
+        elif op == 4:  # Any printable character, or a comment or $ character
+            c = rng.choice(['(', ')', ';', '$', '=', '/', '%', ' ', chr(rng.randint(32, 126))])
+            line = line[:pos] + c + line[pos:]
+        elif op == 5 and line:  # Change the case
+            line = line.swapcase()
+    return line[:250]
+
+
+def is_unsafe(line, settings):
+    upper = line.upper().replace(' ', '')
+    if '?' in line or '~' in line or '!' in line:
+        return True  # Realtime characters are not part of the line
+    if not upper.startswith('$'):
+        return False
+    if settings:
+        return False
+    return '=' in upper and not upper.startswith('$J=') or any(upper.startswith(p) for p in UNSAFE_PREFIXES)
+
+
+class Controller:
+    def __init__(self, device, baud, timeout):
+        self.s = serial.Serial(device, baud, timeout=0.05)
+        self.timeout = timeout
+        self.name = device
+
+    def reset(self):
+        self.s.write(b'\x18')
+        self.wait_banner(5.0)
+        self.command('$C')  # Check mode
+
+    def wait_banner(self, seconds):
+        deadline = time.time() + seconds
+        while time.time() < deadline:
+            if self.s.readline().decode(errors='replace').startswith('Grbl'):
+                break
+        time.sleep(0.5)
+        self.s.reset_input_buffer()
+
+    def command(self, line):
+        """Sends a line. Returns the answer, or why there was none."""
+        self.s.write((line + '\n').encode(errors='replace'))
+        deadline = time.time() + self.timeout
+        while time.time() < deadline:
+            out = self.s.readline().decode(errors='replace').strip()
+            if out == 'ok' or out.startswith('error'):
+                return out
+            if out.startswith('Grbl') or 'Guru Meditation' in out or out.startswith('rst:') or 'Backtrace' in out:
+                return 'reboot: ' + out
+            if out.startswith('ALARM'):
+                return out
+        return 'timeout'
+
+
+def save_crash(crashes, history, why):
+    os.makedirs(crashes, exist_ok=True)
+    path = os.path.join(crashes, 'crash-%d.nc' % int(time.time() * 1000))
+    with open(path, 'w') as f:
+        f.write('; %s\n' % why)
+        f.write('$C\n')
+        for line in history:
+            f.write(line + '\n')
+    return path
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    default_tests = os.path.join(here, '..', '..', 'Grbl_Esp32', 'src', 'tests')
+
+    parser = argparse.ArgumentParser(description='Fuzz the g-code parser and $ commands of a controller.')
+    parser.add_argument('device_file', help='serial device path')
+    parser.add_argument('--reference', help='serial device path of a controller with the reference build')
+    parser.add_argument('--tests', default=default_tests, help='directory of the seed .nc files')
+    parser.add_argument('--crashes', default='fuzz-crashes', help='where failing inputs are saved')
+    parser.add_argument('--count', type=int, default=10000, help='lines to send')
+    parser.add_argument('--seed', type=int, help='random seed, to repeat a run')
+    parser.add_argument('--baud', type=int, default=BAUD_RATE)
+    parser.add_argument('--timeout', type=float, default=2.0, help='seconds to wait for an answer')
+    parser.add_argument('--settings', action='store_true', default=False, help='also send $ lines that write settings')
+    args = parser.parse_args()
+
+    seed = args.seed if args.seed is not None else int(time.time())
+    print('seed %d' % seed)
+    rng = random.Random(seed)
+    seeds = load_seeds(args.tests)
+
+    controllers = [Controller(args.device_file, args.baud, args.timeout)]
+    if args.reference:
+        controllers.append(Controller(args.reference, args.baud, args.timeout))
+    for c in controllers:
+        c.reset()
+
+    history = []
+    failures = 0
+    sent = 0
+    while sent < args.count:
+        line = mutate(rng, seeds)
+        if is_unsafe(line, args.settings):
+            continue
+        sent += 1
+        history.append(line)
+        answers = [c.command(line) for c in controllers]
+        why = None
+        alarm = answers[0].startswith('ALARM')
+        if not (answers[0] == 'ok' or answers[0].startswith('error') or alarm):
+            why = '%s after %r' % (answers[0], line)
+        elif len(answers) > 1 and answers[0] != answers[1]:
+            why = '%s but the reference gives %s for %r' % (answers[0], answers[1], line)
+        if why:
+            failures += 1
+            print('%s, saved to %s' % (why, save_crash(args.crashes, history, why)))
+            for c in controllers:
+                c.reset()
+            history = []
+        elif alarm or line.upper().replace(' ', '') in ('$C', '$X'):
+            # An alarm locks the controller until a reset, $C leaves check mode again, and $X may too
+            for c in controllers:
+                c.reset()
+            history = []
+        if sent % 1000 == 0:
+            print('%d lines, %d failures' % (sent, failures))
+
+    print('%d lines, %d failures' % (sent, failures))
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""\
+Replay the g-code test files on a controller and compare the motion
+with golden traces.
+
+Every .nc file of the test directory is streamed with character
+counting, like stream.py. While it runs, the status is polled and the
+reported position is recorded with the time since the start of the
+file. The responses of the lines, the position trace, the run time and
+the final position make up the result of a file.
+
+    replay.py /dev/ttyUSB0 --record    writes tests/golden/<file>.json
+    replay.py /dev/ttyUSB0             compares the files with them
+
+Use a machine without real I/O, like test_drive.h, so that the runs
+repeat exactly. The responses must be the same, and the final position
+must be within --position-tol. The traces are compared both ways: for
+every sample of one trace, the other one must have passed within
+--position-tol of it, no more than --time-tol seconds (or --time-scale
+of the time into the file) earlier or later. The run time must be
+within the same tolerance, so a planner change that makes a file
+faster by more than that shows up as well.
+
+The controller is reset with ctrl-x before every file. A file fails
+if a line gets no response within --response-timeout, if the status
+polls go unanswered as long, or if the file takes longer than
+--file-timeout.
+
+Requires pySerial.
+"""
+
+import argparse
+import glob
+import json
+import math
+import os
+import re
+import sys
+import time
+
+import serial
+
+RX_BUFFER_SIZE = 128
+BAUD_RATE = 115200
+
+STATUS_RE = re.compile(r'<(\w+)[^|]*\|(MPos|WPos):([-\d.,]+)')
+
+
+class LineReader:
+    """Splits the serial input into lines. readline() of pySerial returns
+    what it has when its timeout expires, which can be part of a line."""
+
+    def __init__(self, s):
+        self.s = s
+        self.buffer = b''
+
+    def readline(self):
+        """Returns the next complete line without the line end, or None."""
+        while b'\n' not in self.buffer:
+            data = self.s.read(max(1, self.s.in_waiting))
+            if not data:
+                return None
+            self.buffer += data
+        line, self.buffer = self.buffer.split(b'\n', 1)
+        return line.decode(errors='replace').strip()
+
+    def reset(self):
+        self.s.reset_input_buffer()
+        self.buffer = b''
+
+
+class ReplayTimeout(Exception):
+    pass
+
+
+def reset(reader):
+    reader.s.write(b'\x18')
+    deadline = time.time() + 5.0
+    while time.time() < deadline:
+        line = reader.readline()
+        if line is not None and line.startswith('Grbl'):
+            break
+    else:
+        raise ReplayTimeout('no Grbl banner after the reset')
+    time.sleep(0.5)
+    reader.reset()
+
+
+def run_file(reader, path, args):
+    """Streams a file. Returns its responses, trace, run time and final position."""
+    lines = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line and not line.startswith(';'):
+                lines.append(line)
+
+    responses = []
+    trace = []
+    in_flight = []  # Lengths of the lines in the serial buffer of the controller
+    sent = 0
+    start = time.time()
+    next_poll = start
+    last_response = start  # Of a line, or the time the oldest line in flight was sent
+    last_status = start
+    state = ''
+    final = None
+    while True:
+        now = time.time()
+        if now - start > args.file_timeout:
+            raise ReplayTimeout('not done after %.0fs' % args.file_timeout)
+        if in_flight and now - last_response > args.response_timeout:
+            raise ReplayTimeout('no response to line %d after %.0fs' % (len(responses) + 1, args.response_timeout))
+        if now - last_status > args.response_timeout:
+            raise ReplayTimeout('no status report after %.0fs' % args.response_timeout)
+        # Keep the buffer of the controller as full as it can be
+        while sent < len(lines) and sum(in_flight) + len(lines[sent]) + 1 < RX_BUFFER_SIZE:
+            if not in_flight:
+                last_response = now
+            reader.s.write((lines[sent] + '\n').encode())
+            in_flight.append(len(lines[sent]) + 1)
+            sent += 1
+        if now >= next_poll:
+            reader.s.write(b'?')
+            next_poll = now + args.interval
+        out = reader.readline()
+        if not out:
+            continue
+        m = STATUS_RE.match(out)
+        if m:
+            last_status = time.time()
+            state = m.group(1)
+            final = {'type': m.group(2), 'pos': [float(v) for v in m.group(3).split(',')]}
+            trace.append([round(time.time() - start, 3)] + final['pos'])
+            if sent == len(lines) and not in_flight and state == 'Idle':
+                break
+        elif out == 'ok' or out.startswith('error'):
+            last_response = time.time()
+            responses.append(out)
+            if in_flight:
+                in_flight.pop(0)
+        elif out.startswith('ALARM'):
+            responses.append(out)
+            break
+    return {
+        'responses': responses,
+        'trace': trace,
+        'time': round(time.time() - start, 3),
+        'final': final,
+    }
+
+
+def distance(a, b):
+    return math.sqrt(sum((x - y) ** 2 for x, y in zip(a, b)))
+
+
+def trace_misses(trace, other, args):
+    """Samples of trace that other does not pass near in time."""
+    misses = []
+    for sample in trace:
+        t = sample[0]
+        window = max(args.time_tol, t * args.time_scale)
+        best = min([distance(o[1:], sample[1:]) for o in other if abs(o[0] - t) <= window], default=float('inf'))
+        # Between two samples the position is linear in time. Check the part of
+        # every segment that lies within the time window.
+        for a, b in zip(other, other[1:]):
+            span = b[0] - a[0]
+            if span <= 0 or b[0] < t - window or a[0] > t + window:
+                continue
+            u0 = max(0.0, (t - window - a[0]) / span)
+            u1 = min(1.0, (t + window - a[0]) / span)
+            d = [q - p for p, q in zip(a[1:], b[1:])]
+            dd = sum(x * x for x in d)
+            u = u0
+            if dd > 0:
+                u = max(u0, min(u1, sum(x * (p - q) for x, p, q in zip(d, sample[1:], a[1:])) / dd))
+            best = min(best, distance([q + u * x for q, x in zip(a[1:], d)], sample[1:]))
+        if best > args.position_tol:
+            misses.append((t, best))
+    return misses
+
+
+def compare(name, golden, result, args):
+    errors = []
+    if golden['responses'] != result['responses']:
+        for n, (g, r) in enumerate(zip(golden['responses'], result['responses'])):
+            if g != r:
+                errors.append('line %d: %s instead of %s' % (n + 1, r, g))
+                break
+        else:
+            errors.append('%d responses instead of %d' % (len(result['responses']), len(golden['responses'])))
+    if golden['final'] and result['final']:
+        if golden['final']['type'] != result['final']['type']:
+            errors.append('%s reported instead of %s' % (result['final']['type'], golden['final']['type']))
+        elif distance(golden['final']['pos'], result['final']['pos']) > args.position_tol:
+            errors.append('final position %s instead of %s' % (result['final']['pos'], golden['final']['pos']))
+    window = max(args.time_tol, golden['time'] * args.time_scale)
+    if abs(result['time'] - golden['time']) > window:
+        errors.append('run time %.3fs instead of %.3fs' % (result['time'], golden['time']))
+    for which, a, b in (('golden', golden['trace'], result['trace']), ('new', result['trace'], golden['trace'])):
+        misses = trace_misses(a, b, args)
+        if misses:
+            t, d = misses[0]
+            errors.append('%d %s trace samples off, first at %.3fs by %.3fmm' % (len(misses), which, t, d))
+    for error in errors:
+        print('  %s: %s' % (name, error))
+    return not errors
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    default_tests = os.path.join(here, '..', '..', 'Grbl_Esp32', 'src', 'tests')
+
+    parser = argparse.ArgumentParser(description='Replay g-code test files and compare them with golden traces.')
+    parser.add_argument('device_file', help='serial device path')
+    parser.add_argument('files', nargs='*', help='.nc files, default all of the test directory')
+    parser.add_argument('--tests', default=default_tests, help='test directory')
+    parser.add_argument('--golden', help='golden trace directory, default <tests>/golden')
+    parser.add_argument('--record', action='store_true', default=False, help='write the golden traces')
+    parser.add_argument('--baud', type=int, default=BAUD_RATE)
+    parser.add_argument('--interval', type=float, default=0.05, help='status poll interval in seconds')
+    parser.add_argument('--position-tol', type=float, default=0.01, help='mm')
+    parser.add_argument('--time-tol', type=float, default=0.1, help='seconds')
+    parser.add_argument('--time-scale', type=float, default=0.02, help='time tolerance as a fraction of the time')
+    parser.add_argument('--response-timeout', type=float, default=30.0, help='seconds to wait for a response')
+    parser.add_argument('--file-timeout', type=float, default=600.0, help='seconds a file may take')
+    args = parser.parse_args()
+
+    golden_dir = args.golden or os.path.join(args.tests, 'golden')
+    files = args.files or sorted(glob.glob(os.path.join(args.tests, '**', '*.nc'), recursive=True))
+
+    s = serial.Serial(args.device_file, args.baud, timeout=0.01)
+    reader = LineReader(s)
+    failed = 0
+    for path in files:
+        name = os.path.splitext(os.path.relpath(path, args.tests))[0]
+        golden_path = os.path.join(golden_dir, name + '.json')
+        print(name)
+        try:
+            reset(reader)
+            result = run_file(reader, path, args)
+        except ReplayTimeout as e:
+            print('  %s: FAILED, %s' % (name, e))
+            failed += 1
+            continue
+        if args.record:
+            os.makedirs(os.path.dirname(golden_path), exist_ok=True)
+            with open(golden_path, 'w') as f:
+                json.dump(result, f, indent=1)
+            continue
+        if not os.path.exists(golden_path):
+            print('  %s: no golden trace' % name)
+            failed += 1
+            continue
+        with open(golden_path) as f:
+            golden = json.load(f)
+        if not compare(name, golden, result, args):
+            failed += 1
+    s.close()
+
+    if args.record:
+        if failed:
+            print('%d of %d files not recorded' % (failed, len(files)))
+    else:
+        print('%d of %d files differ' % (failed, len(files)))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()